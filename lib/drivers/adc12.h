@@ -0,0 +1,241 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "dma.h"
+
+namespace MSP430::Driver::ADC12 {
+    using MSP430::Driver::DMA::TRANSFER;
+    using MSP430::Tools::IOREG;
+
+    /**
+     * Conversion resolution
+     */
+    enum class RESOLUTION : u16 {
+        _8  = 0b00 << 4,
+        _10 = 0b01 << 4,
+        _12 = 0b10 << 4,
+    };
+
+    /**
+     * Sample-and-hold trigger source (`ADC12SHSx`)
+     */
+    enum class TRIGGER : u16 {
+        SOFTWARE = 0b000 << 10,  //!< `ADC12SC` bit
+        TA0CCR1  = 0b001 << 10,
+        TA0CCR2  = 0b010 << 10,
+        TA1CCR1  = 0b011 << 10,
+        TA1CCR2  = 0b100 << 10,
+        TA2CCR1  = 0b101 << 10,
+        TA3CCR1  = 0b110 << 10,
+        TB0CCR1  = 0b111 << 10,
+    };
+
+    /**
+     * Reference voltage (`ADC12VRSEL`)
+     */
+    enum class REFERENCE : u16 {
+        AVCC     = 0b0000 << 8,  //!< AVCC / AVSS
+        VREF_BUF = 0b0001 << 8,  //!< Buffered internal VREF / AVSS
+        VEREF    = 0b0010 << 8,  //!< External VeREF+ / AVSS
+    };
+
+    /**
+     * 12-bit SAR ADC
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct adc12 {
+        enum CTL0e : u16 {
+            SC  = 1 << 0,  //!< Start conversion
+            ENC = 1 << 1,  //!< Enable conversion
+            ON  = 1 << 4,  //!< ADC core on
+            MSC = 1 << 7,  //!< Multiple sample and conversion
+        };
+
+        enum CTL1e : u16 {
+            BUSY             = 1 << 0,
+            CONSEQ_SINGLE    = 0b00 << 1,  //!< Single channel, single shot
+            CONSEQ_SEQUENCE  = 0b01 << 1,  //!< Sequence of channels
+            CONSEQ_REPEAT    = 0b10 << 1,  //!< Repeat single channel
+            CONSEQ_REPEATSEQ = 0b11 << 1,  //!< Repeat sequence
+            SHP              = 1 << 9,     //!< Sampling timer (pulse mode)
+        };
+
+        enum CTL2e : u16 {
+            DF = 1 << 3,  //!< Signed, left aligned result
+        };
+
+        IOREG<u16, addr + 0x00> CTL0;
+        IOREG<u16, addr + 0x02> CTL1;
+        IOREG<u16, addr + 0x04> CTL2;
+        IOREG<u16, addr + 0x06> CTL3;
+        IOREG<u16, addr + 0x0C> IFGR0;
+        IOREG<u16, addr + 0x12> IER0;
+        IOREG<u16, addr + 0x18> IV;
+
+        /**
+         * Conversion memory control register
+         * @tparam nr memory slot 0..31
+         */
+        template <u8 nr>
+        inline IOREG<u16, addr + 0x20 + 2 * nr> mctl() {
+            static_assert(nr < 32);
+            IOREG<u16, addr + 0x20 + 2 * nr> r;
+            return r;
+        }
+
+        /**
+         * Conversion memory register
+         * @tparam nr memory slot 0..31
+         */
+        template <u8 nr>
+        inline IOREG<u16, addr + 0x60 + 2 * nr> mem() {
+            static_assert(nr < 32);
+            IOREG<u16, addr + 0x60 + 2 * nr> r;
+            return r;
+        }
+
+        /**
+         * Configure repeated conversion of a single channel into `MEM0`.
+         * Results are signed and left aligned, i.e. Q15 samples centered
+         * at half of the reference. Conversion is left disabled.
+         * @param channel analog input `A0`..`A31`
+         * @param t sample trigger, a timer output for fixed sample rate
+         * @param r resolution
+         * @param ref reference
+         * @param sht sample-and-hold time code, `4 << sht` clocks up to 7
+         */
+        void setup(u8 channel, TRIGGER t, RESOLUTION r = RESOLUTION::_12,
+                   REFERENCE ref = REFERENCE::AVCC, u8 sht = 2) {
+            disable();
+            CTL0 = ON | ((u16)(sht & 0x0F) << 8);
+            CTL1 = (u16)t | SHP | CONSEQ_REPEAT;
+            CTL2 = (u16)r | DF;
+            CTL3 = 0;
+            mctl<0>() = (u16)ref | (channel & 0x1F);
+        }
+
+        /**
+         * Enable conversions, start them if triggered by software
+         */
+        inline void enable() {
+            if (!(CTL0 && ENC))
+                Power::request(need());
+            if (CTL1 || (0b111 << 10))
+                CTL0 |= ENC;
+            else
+                CTL0 |= MSC | ENC | SC;
+        }
+
+        /**
+         * Stop conversions
+         */
+        inline void disable() {
+            if (CTL0 && ENC)
+                Power::release(need());
+            CTL0 &= ~ENC;
+        }
+
+        /**
+         * Clock the conversion clock needs, for `Power::governor`. MODOSC
+         * is requested by the ADC itself, a trigger timer has its own need.
+         * @return need
+         */
+        inline NEED need() {
+            switch ((CTL1.get() >> 3) & 0b11) {
+                case 0b10: return NEED::CPU;    // MCLK
+                case 0b11: return NEED::SMCLK;  // SMCLK
+                default: return NEED::ACLK;     // MODOSC, ACLK
+            }
+        }
+
+        /**
+         * Turn the ADC core off
+         */
+        inline void off() {
+            disable();
+            CTL0 = 0;
+        }
+    };
+
+    /**
+     * Ping-pong buffers filled from `MEM0` by a repeated DMA transfer.
+     *
+     * DMA writes one buffer while the application processes the other. The
+     * destination for the next block is written while the current one is
+     * being filled, and repeated DMA picks it up at block end, so no sample
+     * is lost when switching. The DMA vector must forward to `isr()`:
+     *
+     *     IRQ_HANDLER(DMA) {
+     *         if (dma.IV.get() == 2 * (0 + 1))  // channel 0
+     *             stream.isr(dma.ch<0>());
+     *     }
+     *
+     * @tparam addr base address of ADC12_B
+     * @tparam N samples per buffer
+     */
+    template <u16 addr, u16 N>
+    struct stream {
+        i16         buffer[2][N];
+        u8          filling;  //!< buffer written by DMA
+        volatile u8 ready;    //!< buffer ready to process, `NONE` if none
+        u16         overruns;  //!< buffers not taken in time
+
+        static constexpr u8 NONE = 0xFF;
+
+        /**
+         * Configure and arm DMA. Start conversions afterwards with
+         * `adc12::enable()`.
+         * @param ch DMA channel (from `dma.ch<n>()`)
+         */
+        template <typename Channel>
+        void start(Channel ch) {
+            filling  = 0;
+            ready    = NONE;
+            overruns = 0;
+            ch.setup((const volatile void *)(addr + 0x60), buffer[0], N,
+                     TRANSFER::REPEATED_SINGLE, Channel::DST_INC | Channel::IE,
+                     DMA::TRIGGER::ADC12);
+            ch.enable();
+            ch.DA = buffer[1];
+        }
+
+        /**
+         * DMA interrupt handler body for the channel given to `start()`
+         */
+        template <typename Channel>
+        inline void isr(Channel ch) {
+            u8 done = filling;
+            filling ^= 1;
+            ch.DA = buffer[done];
+            if (ready != NONE)
+                overruns++;
+            ready = done;
+        }
+
+        /**
+         * Take a filled buffer. It must be processed before DMA comes back
+         * to it, i.e. within `N` sample periods.
+         * @return samples, or null if none ready
+         */
+        inline i16 *take() {
+            // Read and clear at once, a buffer completed in between would
+            // be lost
+            u8 r;
+            {
+                atomic g;
+                r     = ready;
+                ready = NONE;
+            }
+            return r == NONE ? nullptr : buffer[r];
+        }
+    };
+}  // namespace MSP430::Driver::ADC12
@@ -0,0 +1,229 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "crc.h"
+#include "dma.h"
+#include "far.h"
+#include "pmm.h"
+
+/**
+ * A/B firmware images with a resident boot stage.
+ *
+ * Layout (see `msp430fr5994.ld` and `image.ld`):
+ *   - low FRAM and the vector table hold the boot stage, `src/Boot.cpp`,
+ *     linked like any other firmware plus `lib/boot.S`. (The `BOOT`
+ *     region is the ROM bootloader, so the boot stage cannot go there.)
+ *   - `SLOT_A` and `SLOT_B` in FRAM_HI hold application images. Each is
+ *     linked for its slot and starts with a `header`.
+ *
+ * On reset the boot stage starts the newest valid image: magic, slot
+ * number and CRC must match. All vectors point to trampolines that jump
+ * through a table the boot stage fills from the image header, so the
+ * image's `IRQ_HANDLER`s work unchanged.
+ *
+ * A running image writes the other slot in the background, at FRAM speed:
+ *
+ *     u8 n = Boot::image::spare();
+ *     Boot::image::retire(n);
+ *     ... for every received chunk:
+ *         Boot::image::write(n, offset, chunk, len, dma.ch<0>());
+ *     if (Boot::image::commit(n))
+ *         Boot::image::reboot();  // new image runs milliseconds later
+ *
+ * The slot stays invalid until `commit()` has checked the CRC and set the
+ * magic, so an interrupted update keeps the running image. Images are not
+ * position independent: the one linked for `spare()` must be sent. Images
+ * do not call `mpu.start()`, its segments follow the main layout.
+ */
+namespace MSP430::Boot {
+    using MSP430::Driver::DMA::TRANSFER;
+
+    extern "C" {
+        extern char __slot_a[];         //!< start of slot A
+        extern char __slot_b[];         //!< start of slot B
+        extern char __slot_size[];      //!< bytes per slot
+        extern char __image_header[];   //!< running image, images only
+        extern u32  __boot_dispatch[];  //!< trampoline targets, boot only
+        void        vec_Unhandled();
+    }
+
+    /** Interrupt vectors below reset */
+    static constexpr u8  VECTORS = 37;
+    static constexpr u16 MAGIC   = 0xAB1A;
+
+    /**
+     * Image header at the start of a slot. Filled by `image.ld`, except
+     * `crc`, which `tools/imagesign.py` sets after linking.
+     */
+    struct header {
+        u16 crc;               //!< CRC-16/CCITT-FALSE of bytes 2..length-1
+        u16 magic;             //!< `MAGIC`, zero while slot is rewritten
+        u16 version;           //!< higher is newer, modulo 2^16
+        u16 slot;              //!< slot linked for, 0 (A) or 1 (B)
+        u32 length;            //!< bytes of header, code and constants
+        u32 entry;             //!< startup code of the image
+        u32 vectors[VECTORS];  //!< `LEA` .. `System_NMI`, 0 if not handled
+    };
+    static_assert(sizeof(header) == 16 + 4 * VECTORS);
+
+    /**
+     * Image slots
+     * @tparam crcAddr base address of CRC16 module
+     * @tparam pmmAddr base address of PMM
+     */
+    template <u16 crcAddr, u16 pmmAddr>
+    struct slots {
+        /**
+         * Header of a slot
+         * @param n slot, 0 (A) or 1 (B)
+         */
+        static inline const header *slot(u8 n) {
+            return (const header *)(n ? __slot_b : __slot_a);
+        }
+
+        /**
+         * Bytes per slot
+         */
+        static inline u32 size() { return (u32)(__UINTPTR_TYPE__)__slot_size; }
+
+        /**
+         * Image in slot is complete and intact
+         * @param n slot
+         */
+        static bool valid(u8 n) {
+            return Far::read(&slot(n)->magic) == MAGIC && intact(n);
+        }
+
+        /**
+         * Image to start: the valid one, the newer one if both are
+         * @return header, or null if no image is valid
+         */
+        static const header *select() {
+            bool a = valid(0);
+            bool b = valid(1);
+            if (a && b) {
+                i16 d = Far::read(&slot(1)->version)
+                      - Far::read(&slot(0)->version);
+                return slot(d > 0 ? 1 : 0);
+            }
+            return a ? slot(0) : b ? slot(1) : nullptr;
+        }
+
+        /**
+         * Boot stage only: route interrupts to the image and run its
+         * startup code. The dispatch table is written only where it
+         * changes.
+         * @param h header from `select()`
+         */
+        [[noreturn]] static void start(const header *h) {
+            Far::far_iterator<u32> v{h->vectors};
+            for (u8 i = 0; i < VECTORS; i++) {
+                u32 a = v.next();
+                if (!a)
+                    a = (u32)(__UINTPTR_TYPE__)vec_Unhandled;
+                if (__boot_dispatch[i] != a)
+                    __boot_dispatch[i] = a;
+            }
+            auto entry = (void (*)())(__UINTPTR_TYPE__)Far::read(&h->entry);
+            entry();
+            while (true) {
+            }
+        }
+
+        /**
+         * Images only: slot of the running image
+         */
+        static inline u8 running() {
+            return (__UINTPTR_TYPE__)__image_header
+                   == (__UINTPTR_TYPE__)__slot_b;
+        }
+
+        /**
+         * Images only: slot to write updates to
+         */
+        static inline u8 spare() { return running() ^ 1; }
+
+        /**
+         * Invalidate a slot before rewriting it
+         * @param n slot
+         */
+        static inline void retire(u8 n) { put(&slot(n)->magic, 0); }
+
+        /**
+         * Copy part of a new image into a slot by a DMA block transfer. The
+         * magic is held back until `commit()`.
+         * @param n slot, not the running one
+         * @param offset position in slot, even
+         * @param data bytes
+         * @param len number of bytes, even
+         * @param ch DMA channel (from `dma.ch<n>()`)
+         * @return false if outside the slot, or the slot is running
+         */
+        template <typename Channel>
+        static bool write(u8 n, u32 offset, const void *data, u16 len,
+                          Channel ch) {
+            if (n == running() || offset + len > size() || ((offset | len) & 1))
+                return false;
+            char *dst = (n ? __slot_b : __slot_a) + offset;
+            ch.setup(data, dst, len / 2, TRANSFER::BLOCK,
+                     Channel::SRC_INC | Channel::DST_INC);
+            ch.start();
+            if (offset < 4 && offset + len > 2)
+                retire(n);
+            return true;
+        }
+
+        /**
+         * Check a rewritten slot and mark it valid
+         * @param n slot, not the running one
+         * @return false if the image is not intact
+         */
+        static bool commit(u8 n) {
+            if (n == running() || !intact(n))
+                return false;
+            put(&slot(n)->magic, MAGIC);
+            return true;
+        }
+
+        /**
+         * Restart through the boot stage (brownout reset)
+         */
+        [[noreturn]] static void reboot() {
+            Driver::PMM::pmm<pmmAddr> p;
+            p.reset_bor();
+        }
+
+      private:
+        /**
+         * Slot number, length and CRC match; magic is taken as set
+         */
+        static bool intact(u8 n) {
+            const header *h = slot(n);
+            if (Far::read(&h->slot) != n)
+                return false;
+            u32 len = Far::read(&h->length);
+            if (len < sizeof(header) || len > size())
+                return false;
+            Driver::CRC::crc<crcAddr> c;
+            c.seed();
+            c.add((u8)MAGIC);
+            c.add((u8)(MAGIC >> 8));
+            c.add((const u8 *)h + 4, len - 4);
+            return c.result() == Far::read(&h->crc);
+        }
+
+        static inline void put(const u16 *p, u16 v) {
+            __asm__ volatile("movx.w %1, 0(%0)" ::"r"(p), "r"(v) : "memory");
+        }
+    };
+
+    typedef slots<0x150, 0x120> image;
+}  // namespace MSP430::Boot
@@ -0,0 +1,247 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "dma.h"
+#include "ring.h"
+#include "timer.h"
+
+namespace MSP430::Driver::Capture {
+    using MSP430::Driver::DMA::TRANSFER;
+    using MSP430::Driver::DMA::TRIGGER;
+    using MSP430::Tools::ring;
+
+    /**
+     * Captured edge(s)
+     */
+    enum class EDGE : u16 {
+        RISING  = 0b01u << 14,
+        FALLING = 0b10u << 14,
+        BOTH    = 0b11u << 14,
+    };
+
+    /**
+     * Capture input
+     */
+    enum class INPUT : u16 {
+        A = 0b00 << 12,  //!< CCIxA, usually a pin
+        B = 0b01 << 12,  //!< CCIxB, pin or internal signal (ACLK, COUT...)
+    };
+
+    /**
+     * Ticks between two timestamps
+     */
+    inline u32 period(u32 from, u32 to) { return to - from; }
+
+    /**
+     * Frequency of a signal
+     * @param ticks period in timer ticks
+     * @param timer_hz timer clock
+     * @return frequency in Hz, 0 for empty period
+     */
+    inline u32 frequency(u32 ticks, u32 timer_hz) {
+        return ticks ? timer_hz / ticks : 0;
+    }
+
+    /**
+     * Duty cycle from three consecutive edges (both-edge capture)
+     * @param rise leading edge
+     * @param fall trailing edge
+     * @param next next leading edge
+     * @return high time as Q15 fraction of period
+     */
+    inline u16 duty_q15(u32 rise, u32 fall, u32 next) {
+        u32 high = fall - rise;
+        u32 per  = next - rise;
+        while (per > 0xFFFFu) {
+            per >>= 1;
+            high >>= 1;
+        }
+        return per ? (u16)((high << 15) / per) : 0;
+    }
+
+    /**
+     * Input capture engine with 32-bit timestamps.
+     *
+     * Timer runs in continuous mode, its overflows (`TAIFG`) extend the
+     * 16-bit captures to 32 bits. When a capture and an overflow are pending
+     * at once, `TAxIV` serves the capture first; a small captured value
+     * with `TAIFG` still pending means the capture came after the overflow,
+     * so the high word is bumped for that capture only.
+     *
+     * The timer's CCR1 vector must forward to `isr()`:
+     *
+     *     IRQ_HANDLER(TA1_CCR1) { flow.isr(); }
+     *
+     * @tparam addr base address of timer
+     * @tparam ccrCount capture register count for this specific timer
+     * @tparam nr channel, 1..ccrCount-1 (CCR0 has its own vector)
+     * @tparam N timestamp ring size, power of 2
+     */
+    template <u16 addr, u8 ccrCount, u8 nr, u16 N = 16>
+    struct capture {
+        static_assert(nr >= 1 && nr < ccrCount, "CCR0 is not supported");
+        typedef Timer::TA<addr, ccrCount> TA;
+
+        static constexpr u16 IV_CAPTURE  = 2 * nr;
+        static constexpr u16 IV_OVERFLOW = 0x0E;
+
+        ring<u32, N> stamps;
+        volatile u16 high;    //!< timer overflow count
+        u16          missed;  //!< captures lost due to full ring or COV
+
+        /**
+         * Configure channel and start timer in continuous mode.
+         * @param e captured edge(s)
+         * @param in capture input
+         * @param clock `TA::CLK_*` | `TA::DIV_*`
+         */
+        void start(EDGE e, INPUT in = INPUT::A,
+                   u16 clock = TA::CLK_SM | TA::DIV_1) {
+            TA t;
+            stamps.clear();
+            high   = 0;
+            missed = 0;
+            t.template cctl<nr>() =
+                (u16)e | (u16)in | TA::SCS | TA::CAP | TA::CCIE;
+            t.start(clock | TA::CONT | TA::TBIE_E);
+        }
+
+        /**
+         * Stop timer and capture
+         */
+        void stop() {
+            TA t;
+            t.template cctl<nr>() = 0;
+            t.stop();
+            t.CTL = 0;
+        }
+
+        /**
+         * Current time, extended to 32 bits
+         * @return timestamp
+         */
+        inline u32 now() {
+            TA  t;
+            u16 h, l;
+            do {
+                h = high;
+                l = t.R.get();
+            } while (h != high);
+            if ((t.CTL && TA::TBIFG_P) && l < 0x8000)
+                h++;
+            return ((u32)h << 16) | l;
+        }
+
+        /**
+         * Interrupt handler body, costs one `TAxIV` read and a ring push
+         */
+        inline void isr() {
+            TA t;
+            switch (t.IV.get()) {
+                case IV_CAPTURE: {
+                    u16 c = t.template ccr<nr>().get();
+                    u16 h = high;
+                    if ((t.CTL && TA::TBIFG_P) && c < 0x8000)
+                        h++;
+                    if (t.template cctl<nr>() && TA::COV) {
+                        t.template cctl<nr>() &= ~TA::COV;
+                        missed++;
+                    }
+                    if (!stamps.push(((u32)h << 16) | c))
+                        missed++;
+                    break;
+                }
+                case IV_OVERFLOW: {
+                    high = high + 1;
+                    break;
+                }
+            }
+        }
+
+        /**
+         * Take oldest timestamp
+         * @param v receives timestamp
+         * @return false if none
+         */
+        inline bool pop(u32 &v) { return stamps.pop(v); }
+    };
+
+    /**
+     * DMA-fed capture on CCR2, for edge rates where even a minimal ISR is
+     * too much. Each capture is copied by DMA into a circular buffer of raw
+     * 16-bit values, without CPU involvement. Values are extended to 32 bits
+     * while read, so consecutive edges must be less than 65536 ticks apart
+     * and the reader must keep up with `N` edges.
+     * @tparam addr base address of timer (TA0, TA1 or TB0)
+     * @tparam ccrCount capture register count for this specific timer
+     * @tparam N buffer size
+     */
+    template <u16 addr, u8 ccrCount, u16 N = 32>
+    struct capture_dma {
+        typedef Timer::TA<addr, ccrCount> TA;
+
+        u16 raw[N];
+        u16 read;  //!< next slot to read
+        u16 last;  //!< last raw value read
+        u32 time;  //!< last extended timestamp
+
+        /**
+         * Configure CCR2, DMA channel and start timer
+         * @param ch DMA channel (from `dma.ch<n>()`)
+         * @param e captured edge(s)
+         * @param in capture input
+         * @param clock `TA::CLK_*` | `TA::DIV_*`
+         */
+        template <typename Channel>
+        void start(Channel ch, EDGE e, INPUT in = INPUT::A,
+                   u16 clock = TA::CLK_SM | TA::DIV_1) {
+            TA t;
+            read = last = 0;
+            time        = 0;
+            t.template cctl<2>() = (u16)e | (u16)in | TA::SCS | TA::CAP;
+            ch.setup((const volatile void *)(addr + 0x16), raw, N,
+                     TRANSFER::REPEATED_SINGLE, Channel::DST_INC, trigger());
+            ch.enable();
+            t.start(clock | TA::CONT);
+        }
+
+        /**
+         * Take oldest timestamp
+         * @param ch DMA channel given to `start()`
+         * @param v receives timestamp
+         * @return false if none
+         */
+        template <typename Channel>
+        inline bool pop(Channel ch, u32 &v) {
+            u16 write = N - ch.SZ.get();
+            if (write == N)
+                write = 0;
+            if (read == write)
+                return false;
+            u16 r = raw[read];
+            time += (u16)(r - last);
+            last = r;
+            if (++read == N)
+                read = 0;
+            v = time;
+            return true;
+        }
+
+      private:
+        static constexpr TRIGGER trigger() {
+            static_assert(addr == 0x340 || addr == 0x380 || addr == 0x3C0,
+                          "CCR2 DMA trigger exists only for TA0, TA1, TB0");
+            return addr == 0x340   ? TRIGGER::TA0CCR2
+                   : addr == 0x380 ? TRIGGER::TA1CCR2
+                                   : TRIGGER::TB0CCR2;
+        }
+    };
+}  // namespace MSP430::Driver::Capture
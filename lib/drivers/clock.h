@@ -9,6 +9,8 @@
 #pragma once
 
 #include "tools.h"
+#include "fram.h"
+#include "timer.h"
 
 namespace MSP430::Driver::Clock {
     using MSP430::Tools::IOREG;
@@ -78,6 +80,16 @@ namespace MSP430::Driver::Clock {
         // _16_24 = 3, //!< Greater than 16 MHz to 24 MHz
     };
 
+    /**
+     * Runtime (measured) clock frequencies, for drivers that derive
+     * divisors or delays from real clocks instead of nominal ones.
+     */
+    struct frequency {
+        u32 mclk;   //!< MCLK in Hz
+        u32 smclk;  //!< SMCLK in Hz
+        u32 aclk;   //!< ACLK in Hz
+    };
+
     template <u16 addr>
     struct cs {
       private:
@@ -208,5 +220,212 @@ namespace MSP430::Driver::Clock {
             Mutator t(*this, true);
             return t;
         }
+
+        /**
+         * Nominal frequencies of the current setup, from DCO tap and
+         * dividers. LFXT counts as 32768 Hz, VLO and MODCLK at their
+         * typical rates, HFXT as DCO (its crystal is not known here).
+         * @param f receives frequencies
+         */
+        void nominal(frequency &f) {
+            u16 ctl2 = CTL2.get();
+            u16 ctl3 = CTL3.get();
+            f.mclk   = source(ctl2 & 0b111) >> (ctl3 & 0b111);
+            f.smclk  = source((ctl2 >> 4) & 0b111) >> ((ctl3 >> 4) & 0b111);
+            f.aclk   = source((ctl2 >> 8) & 0b111) >> ((ctl3 >> 8) & 0b111);
+        }
+
+      private:
+        u32 source(u16 sel) {
+            static constexpr u32 dco[2][8] = {
+                {1000000, 2670000, 3500000, 4000000, 5330000, 7000000,
+                 8000000, 8000000},
+                {1000000, 5330000, 7000000, 8000000, 16000000, 21000000,
+                 24000000, 24000000},
+            };
+            switch ((MCLK)sel) {
+                case MCLK::LFXTCLK: return 32768;
+                case MCLK::VLOCLK: return 9400;
+                case MCLK::LFMODCLK: return 5000000 / 128;
+                case MCLK::MODCLK: return 5000000;
+                default: {
+                    u16 ctl1 = CTL1.get();
+                    return dco[(ctl1 >> 6) & 1][(ctl1 >> 1) & 0b111];
+                }
+            }
+        }
+    };
+
+    /**
+     * DCO measurement and trimming against 32.768 kHz LFXT.
+     *
+     * The timer counts SMCLK, while one of its channels captures ACLK edges
+     * (on TA0/TA1 `CCI2B` is internally tied to ACLK). Ticks between
+     * `2^periodsLog2` ACLK periods give SMCLK with crystal accuracy. ACLK
+     * must be sourced from LFXT.
+     *
+     * FR5994 DCO has no fine trim, only taps (`DCO`) and clock dividers, so
+     * `tune()` picks the tap and divider combination measured closest to the
+     * target. The result of every measurement is published in a `frequency`
+     * structure.
+     *
+     * @tparam csAddr base address of clock system
+     * @tparam timerAddr base address of timer used for measurement
+     * @tparam ccrCount capture register count for this specific timer
+     * @tparam nr channel having ACLK as `CCIxB`
+     * @tparam frctlAddr base address of FRAM controller
+     */
+    template <u16 csAddr, u16 timerAddr, u8 ccrCount, u8 nr = 2,
+              u16 frctlAddr = 0x140>
+    struct dco_trim {
+        typedef Timer::TA<timerAddr, ccrCount> TA;
+        typedef FRAM::frctl<frctlAddr>         FRCTL;
+
+        static constexpr u32 LFXT_HZ = 32768;
+
+        i16  last_temp = 0;      //!< temperature of last `retrim()`
+        bool trimmed   = false;  //!< `last_temp` is valid
+
+        /**
+         * Measure SMCLK against ACLK and publish all clock frequencies.
+         * Busy-waits `2^periodsLog2` ACLK periods (1 ms for default).
+         * @tparam periodsLog2 log2 of ACLK periods to measure
+         * @param f receives frequencies
+         * @return SMCLK in Hz
+         */
+        template <u8 periodsLog2 = 5>
+        u32 measure(frequency &f) {
+            static_assert(periodsLog2 <= 15);
+            TA t;
+            t.CTL = TA::TBCLR;
+            t.template cctl<nr>() =
+                TA::CM_RISING | TA::CCIS_B | TA::SCS | TA::CAP;
+            t.CTL = TA::CLK_SM | TA::DIV_1 | TA::CONT;
+
+            // Timer was just cleared, so first edge (at most 30 us away) is
+            // captured before any overflow.
+            u16 high  = 0;
+            u16 first = edge(high);
+            u16 last  = first;
+            for (u16 i = 0; i < (1u << periodsLog2); i++)
+                last = edge(high);
+            t.template cctl<nr>() = 0;
+            t.CTL                 = 0;
+
+            u32 ticks = (((u32)high << 16) | last) - first;
+            u32 smclk = ticks << (15 - periodsLog2);
+
+            cs<csAddr> c;
+            u16        ctl2 = c.CTL2.get();
+            u16        ctl3 = c.CTL3.get();
+            u16        sdiv = (ctl3 >> 4) & 0b111;
+            u16        mdiv = ctl3 & 0b111;
+            f.smclk         = smclk;
+            f.aclk          = LFXT_HZ >> ((ctl3 >> 8) & 0b111);
+            if (((ctl2 >> 4) & 0b111) == (ctl2 & 0b111))
+                f.mclk = (smclk << sdiv) >> mdiv;
+            return smclk;
+        }
+
+        /**
+         * Select DCO tap and SMCLK/MCLK divider closest to target frequency,
+         * by measuring each candidate (about 1 ms each). Both MCLK and SMCLK
+         * are switched to DCOCLK with the same divider.
+         * @param f receives frequencies of selected setting
+         * @param target_hz wanted MCLK/SMCLK frequency, clamped to 16 MHz
+         * @return absolute error of selected setting in Hz
+         */
+        u32 tune(frequency &f, u32 target_hz) {
+            // 21 and 24 MHz taps exceed the FR5994 MCLK limit
+            static constexpr DCO taps[] = {
+                DCO::_1_00MHz, DCO::_2_67MHz, DCO::_3_50MHz, DCO::_4_00MHz,
+                DCO::_5_33MHz, DCO::_7_00MHz, DCO::_8_00MHz, DCO::_16_00MHz,
+            };
+            static constexpr u32 nominal[] = {
+                1000000, 2670000, 3500000, 4000000,
+                5330000, 7000000, 8000000, 16000000,
+            };
+
+            cs<csAddr> c;
+            FRCTL      fr;
+            u32        best_err = ~(u32)0;
+            u8         best_tap = 0, best_div = 0;
+
+            if (target_hz > FRCTL::MAX_HZ)
+                target_hz = FRCTL::MAX_HZ;
+            // Candidates go up to target + 12.5% (but not above the device
+            // limit), so wait states must be ready for the fastest one
+            // before any switching.
+            u32 fastest = target_hz + target_hz / 8;
+            if (fastest > FRCTL::MAX_HZ)
+                fastest = FRCTL::MAX_HZ;
+            fr.set_wait_states(FRCTL::wait_states(fastest));
+            for (u8 i = 0; i < sizeof(taps) / sizeof(taps[0]); i++) {
+                for (u8 d = 0; d <= (u8)DIV::_32; d++) {
+                    u32 n = nominal[i] >> d;
+                    if (n < target_hz - target_hz / 8 || n > fastest)
+                        continue;
+                    c.Update()
+                        .Set_DCO(taps[i])
+                        .Set_MCLK(MCLK::DCOCLK, (DIV)d)
+                        .Set_SMCLK(MCLK::DCOCLK, (DIV)d);
+                    u32 m   = measure(f);
+                    u32 err = m > target_hz ? m - target_hz : target_hz - m;
+                    if (err < best_err) {
+                        best_err = err;
+                        best_tap = i;
+                        best_div = d;
+                    }
+                }
+            }
+            if (best_err != ~(u32)0) {
+                c.Update()
+                    .Set_DCO(taps[best_tap])
+                    .Set_MCLK(MCLK::DCOCLK, (DIV)best_div)
+                    .Set_SMCLK(MCLK::DCOCLK, (DIV)best_div);
+            }
+            measure(f);
+            fr.set_wait_states(FRCTL::wait_states(f.mclk));
+            return best_err;
+        }
+
+        /**
+         * Re-measure if temperature moved far enough since last measurement.
+         * Call periodically (e.g. from RTC tick), with any temperature source.
+         * @param f receives frequencies
+         * @param temp current temperature
+         * @param delta temperature change that triggers measurement
+         * @return true if re-measured
+         */
+        bool retrim(frequency &f, i16 temp, i16 delta = 5) {
+            i16 d = temp - last_temp;
+            if (trimmed && d < delta && d > -delta)
+                return false;
+            last_temp = temp;
+            trimmed   = true;
+            measure(f);
+            return true;
+        }
+
+      private:
+        /**
+         * Wait for next captured ACLK edge, counting timer overflows. An
+         * ACLK period is far shorter than the timer period, so at most one
+         * overflow is pending at a capture. It came before the capture if
+         * the captured value is small; otherwise it is left pending for
+         * the next edge.
+         */
+        static inline u16 edge(u16 &high) {
+            TA t;
+            while (!(t.template cctl<nr>() || TA::CCIFG)) {
+            }
+            t.template cctl<nr>() &= ~TA::CCIFG;
+            u16 c = t.template ccr<nr>().get();
+            if ((t.CTL || TA::TBIFG_P) && c < 0x8000) {
+                t.CTL &= ~TA::TBIFG_P;
+                high++;
+            }
+            return c;
+        }
     };
 }  // namespace MSP430::Driver::Clock
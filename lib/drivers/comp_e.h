@@ -0,0 +1,200 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Driver::COMP_E {
+    using MSP430::Tools::IOREG;
+
+    /**
+     * Voltage applied to the reference resistor ladder
+     */
+    enum class REFERENCE : u16 {
+        VCC   = (0b01 << 6),                 //!< Supply voltage
+        V_1_2 = (0b10 << 6) | (0b01 << 13),  //!< Shared 1.2 V reference
+        V_2_0 = (0b10 << 6) | (0b10 << 13),  //!< Shared 2.0 V reference
+        V_2_5 = (0b10 << 6) | (0b11 << 13),  //!< Shared 2.5 V reference
+    };
+
+    /**
+     * Output edge that raises the interrupt
+     */
+    enum class EDGE {
+        RISING,   //!< Input went above threshold
+        FALLING,  //!< Input went below threshold
+        BOTH,
+    };
+
+    /**
+     * Speed/current trade-off
+     */
+    enum class POWER : u16 {
+        HIGH_SPEED = 0b00 << 8,
+        NORMAL     = 0b01 << 8,
+        ULTRA_LOW  = 0b10 << 8,  //!< Lowest current, slowest response
+    };
+
+    /**
+     * Output filter delay
+     */
+    enum class FILTER : u16 {
+        NONE   = 0,
+        NS_450 = (1 << 2) | (0b00 << 6),
+        NS_900 = (1 << 2) | (0b01 << 6),
+        US_1_8 = (1 << 2) | (0b10 << 6),
+        US_3_6 = (1 << 2) | (0b11 << 6),
+    };
+
+    /**
+     * Source of comparator interrupt, as decoded from `CEIV`
+     */
+    enum class SOURCE : u16 {
+        NONE     = 0x00,
+        EDGE     = 0x02,  //!< Edge selected by `CEIES` (`CEIFG`)
+        INVERTED = 0x04,  //!< Opposite edge (`CEIIFG`)
+    };
+
+    /**
+     * Comparator_E with a threshold from the internal reference ladder.
+     *
+     * The watched signal goes to the + terminal, the ladder to the - one.
+     * With two different ladder taps the comparator has hysteresis:
+     * `high` tap is used while the output is low (so it is the rising
+     * threshold), `low` tap while the output is high. Comparator keeps
+     * working in LPM3/LPM4, so an edge interrupt wakes the CPU only when
+     * the threshold is actually crossed.
+     *
+     * The output `COUT` is also internally wired to `CCI1B` of TA0 and TA1.
+     * Starting `Capture::capture<0x340, 3, 1>` with `INPUT::B` timestamps
+     * every zero (threshold) crossing without any comparator interrupt.
+     *
+     * Vector must forward to `isr()` when interrupts are used:
+     *
+     *     IRQ_HANDLER(Comparator_E) { comp_e.isr(); }
+     *
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct comp_e {
+        enum CTL0e : u16 {
+            IPEN = 1 << 7,    //!< + terminal connected to `CEIPSEL` channel
+            IMEN = 1u << 15,  //!< - terminal connected to `CEIMSEL` channel
+        };
+
+        enum CTL1e : u16 {
+            OUT    = 1 << 0,   //!< Comparator output value
+            OUTPOL = 1 << 1,   //!< Output inverted
+            IES    = 1 << 3,   //!< `CEIFG` on falling edge (otherwise rising)
+            SHORT  = 1 << 4,   //!< Inputs shorted
+            EX     = 1 << 5,   //!< Inputs exchanged
+            ON     = 1 << 10,  //!< Comparator on
+            MRVL   = 1 << 11,  //!< Manual reference: use `CEREF1`
+            MRVS   = 1 << 12,  //!< Manual reference select (otherwise `OUT`)
+        };
+
+        enum CTL2e : u16 {
+            RSEL = 1 << 5,  //!< Reference goes to - terminal
+        };
+
+        enum INTe : u16 {
+            IFG  = 1 << 0,  //!< Output edge interrupt flag
+            IIFG = 1 << 1,  //!< Inverted edge interrupt flag
+            IE   = 1 << 8,  //!< Output edge interrupt enable
+            IIE  = 1 << 9,  //!< Inverted edge interrupt enable
+        };
+
+        IOREG<u16, addr + 0x00> CTL0;
+        IOREG<u16, addr + 0x02> CTL1;
+        IOREG<u16, addr + 0x04> CTL2;
+        IOREG<u16, addr + 0x06> CTL3;
+        IOREG<u16, addr + 0x0C> INT;
+        IOREG<u16, addr + 0x0E> IV;
+
+        /**
+         * Connect external channel to + terminal. Input buffer of its pin
+         * is disabled to avoid cross-current at intermediate voltages.
+         * @param ch channel `C0`..`C15`
+         */
+        inline void input(u8 ch) {
+            CTL3 = 1u << (ch & 0x0F);
+            CTL0 = IPEN | (ch & 0x0F);
+        }
+
+        /**
+         * Set threshold from reference ladder. Voltage of a tap `n` is
+         * `Vref * (n + 1) / 32`.
+         * @param ref ladder reference
+         * @param high rising threshold tap, 0..31
+         * @param low falling threshold tap, 0..31, `low <= high`;
+         * same as `high` for no hysteresis
+         */
+        inline void threshold(REFERENCE ref, u8 high, u8 low) {
+            CTL2 = (u16)ref | RSEL | ((u16)(low & 0x1F) << 8) | (high & 0x1F);
+            CTL1 &= ~MRVS;
+        }
+
+        /**
+         * Set threshold without hysteresis
+         * @param ref ladder reference
+         * @param tap tap, 0..31
+         */
+        inline void threshold(REFERENCE ref, u8 tap) {
+            threshold(ref, tap, tap);
+        }
+
+        /**
+         * Turn the comparator on
+         * @param p power mode
+         * @param f output filter
+         */
+        inline void on(POWER p = POWER::NORMAL, FILTER f = FILTER::NONE) {
+            CTL1 = (u16)p | (u16)f | ON;
+        }
+
+        /**
+         * Turn the comparator off, ladder draws no current
+         */
+        inline void off() {
+            CTL1 = 0;
+            CTL2 = 0;
+        }
+
+        /**
+         * Current state of the comparator
+         * @return true if input is above threshold
+         */
+        inline bool above() { return CTL1 || OUT; }
+
+        /**
+         * Enable interrupt on output edge(s). Stale flags are dropped, so
+         * only crossings after this call are reported.
+         * @param e edge(s)
+         */
+        void enable_irq(EDGE e) {
+            INT = 0;
+            if (e == EDGE::FALLING)
+                CTL1 |= IES;
+            else
+                CTL1 &= ~IES;
+            INT = (e == EDGE::BOTH) ? (IE | IIE) : IE;
+        }
+
+        /**
+         * Disable comparator interrupts
+         */
+        inline void disable_irq() { INT = 0; }
+
+        /**
+         * Interrupt handler body: acknowledges highest pending source
+         * @return source served
+         */
+        inline SOURCE isr() { return (SOURCE)IV.get(); }
+    };
+}  // namespace MSP430::Driver::COMP_E
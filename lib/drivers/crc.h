@@ -0,0 +1,59 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "far.h"
+
+namespace MSP430::Driver::CRC {
+    using MSP430::Tools::IOREG;
+
+    /**
+     * CRC16 module, CRC-CCITT polynomial (0x1021).
+     *
+     * Bytes are fed through the bit-reversed input, so the result matches
+     * the common CRC-16/CCITT-FALSE (initial 0xFFFF, MSB first, no final
+     * XOR, `0x29B1` for "123456789") computed on the host.
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct crc {
+        IOREG<u16, addr + 0x00> DI;      //!< Data in
+        IOREG<u8, addr + 0x02>  DIRB_L;  //!< Data in, bit-reversed
+        IOREG<u16, addr + 0x04> INIRES;  //!< Seed, result
+        IOREG<u16, addr + 0x06> RESR;    //!< Result, bit-reversed
+
+        /**
+         * Start new checksum
+         * @param seed initial value
+         */
+        inline void seed(u16 seed = 0xFFFF) { INIRES = seed; }
+
+        /**
+         * Add single byte
+         */
+        inline void add(u8 b) { DIRB_L = b; }
+
+        /**
+         * Add bytes, anywhere in memory (20-bit reads)
+         * @param data first byte
+         * @param n number of bytes
+         */
+        void add(const u8 *data, u32 n) {
+            Far::far_iterator<u8> it{data};
+            for (; n; n--)
+                DIRB_L = it.next();
+        }
+
+        /**
+         * Checksum of bytes fed since `seed()`
+         */
+        inline u16 result() { return INIRES.get(); }
+    };
+}  // namespace MSP430::Driver::CRC
@@ -0,0 +1,231 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "gpio.h"
+#include "ring.h"
+#include "timer.h"
+
+namespace MSP430::Driver::Debounce {
+    using MSP430::Tools::ring;
+
+    /**
+     * Debounced input change
+     */
+    struct event {
+        u8  pin;      //!< `8 * (port - 1) + bit`, e.g. 37 for P5.5
+        u8  pressed;  //!< 1: became active, 0: became inactive
+        u16 stamp;    //!< timer count at the first edge
+    };
+
+    /**
+     * Debounced input engine for P1..P8.
+     *
+     * The first edge on a pin masks its interrupt and records a timestamp;
+     * bounces that follow cost nothing. One shared timer compare, `SETTLE`
+     * ticks later, re-samples all masked pins of all ports in one pass,
+     * queues an event for each pin whose stable level changed, and unmasks
+     * them with the edge set against the new level. Pins that were masked
+     * after the compare had been armed wait for the next one, so every pin
+     * settles for `SETTLE` to `2 * SETTLE` ticks.
+     *
+     * Port vectors serve one pin per entry through `PxIV` (highest priority
+     * pending pin first), and the timer channel has its own vector:
+     *
+     *     IRQ_HANDLER(P5) { buttons.port_isr<5>(); }
+     *     IRQ_HANDLER(TA3_CCR1) { buttons.timer_isr(); }
+     *
+     * Cost: `port_isr()` is constant time: `PxIV` read, mask, timestamp
+     * store and, for the first pin of a batch, arming the compare.
+     * `timer_isr()` is linear in the number of ports with masked pins and
+     * pins changed, bounded by 8 ports and 64 pins. `src/InputDemo.cpp`
+     * measures both worst cases with the profiler.
+     *
+     * @tparam addr base address of timer, counting in continuous mode
+     * @tparam ccrCount capture register count for this specific timer
+     * @tparam nr compare channel, 1..ccrCount-1 (CCR0 has its own vector)
+     * @tparam SETTLE settle time in timer ticks
+     * @tparam N event queue size, power of 2
+     */
+    template <u16 addr, u8 ccrCount, u8 nr, u16 SETTLE, u16 N = 16>
+    struct debouncer {
+        static_assert(nr >= 1 && nr < ccrCount, "CCR0 is not supported");
+        static_assert(SETTLE > 0 && SETTLE < 0x8000);
+        typedef Timer::TA<addr, ccrCount> TA;
+
+        u8             level[8];   //!< stable level of attached pins
+        u8             invert[8];  //!< active-low pins
+        u8             due[8];     //!< masked, sampled on next compare
+        u8             late[8];    //!< masked after compare was armed
+        u16            stamp[64];  //!< time of first edge per pin
+        ring<event, N> events;
+        u16            dropped;  //!< events lost to full queue
+
+        /**
+         * Clear state and start timer (from ACLK) unless already running.
+         * Call before `attach()`.
+         */
+        void start(u16 clock = TA::CLK_A | TA::DIV_1) {
+            TA t;
+            for (u8 p = 0; p < 8; p++)
+                level[p] = invert[p] = due[p] = late[p] = 0;
+            events.clear();
+            dropped = 0;
+            t.template cctl<nr>() = 0;
+            if (!(t.CTL || TA::MODE_M))
+                t.start(clock | TA::CONT);
+        }
+
+        /**
+         * Configure pins as inputs with pull resistors and watch them.
+         * Call after `pmm.unlock_pm5()`: the initial level is sampled here,
+         * and port settings (pull resistors) apply only once unlocked.
+         * @tparam port port number, 1..8
+         * @param pins pin mask
+         * @param active_low pressed when low (pull-up), otherwise when high
+         * (pull-down)
+         */
+        template <u8 port>
+        void attach(u8 pins, bool active_low = true) {
+            static_assert(port >= 1 && port <= 8);
+            GPIO::port_int<base(port)> p;
+            p.set_function(GPIO::FUNCTION::GPIO, pins);
+            p.set_mode(active_low ? GPIO::MODE::IN_PULLUP
+                                  : GPIO::MODE::IN_PULLDOWN,
+                       pins);
+            p.IE &= ~pins;
+            if (active_low)
+                invert[port - 1] |= pins;
+            else
+                invert[port - 1] &= ~pins;
+            rearm<port>(pins, p.IN.get());
+        }
+
+        /**
+         * Stop watching pins
+         * @tparam port port number, 1..8
+         * @param pins pin mask
+         */
+        template <u8 port>
+        void detach(u8 pins) {
+            GPIO::port_int<base(port)> p;
+            p.IE &= ~pins;
+            due[port - 1] &= ~pins;
+            late[port - 1] &= ~pins;
+        }
+
+        /**
+         * Port interrupt handler body
+         * @tparam port port number, 1..8
+         */
+        template <u8 port>
+        inline void port_isr() {
+            GPIO::port_int<base(port)> p;
+            TA                         t;
+            u16                        iv = p.IV.get();
+            if (!iv)
+                return;
+            u8 bit  = (iv >> 1) - 1;
+            u8 mask = 1u << bit;
+            p.IE &= ~mask;
+            u16 now                     = t.R.get();
+            stamp[8 * (port - 1) + bit] = now;
+            if (t.template cctl<nr>() || TA::CCIE) {
+                late[port - 1] |= mask;
+            } else {
+                due[port - 1] |= mask;
+                t.template ccr<nr>()  = now + SETTLE;
+                t.template cctl<nr>() = TA::CCIE;
+            }
+        }
+
+        /**
+         * Timer channel interrupt handler body
+         */
+        inline void timer_isr() {
+            TA t;
+            t.template cctl<nr>() = 0;
+            resample<1>();
+
+            bool more = false;
+            for (u8 p = 0; p < 8; p++) {
+                due[p]  = late[p];
+                late[p] = 0;
+                more |= due[p] != 0;
+            }
+            if (more) {
+                t.template ccr<nr>()  = t.R.get() + SETTLE;
+                t.template cctl<nr>() = TA::CCIE;
+            }
+        }
+
+        /**
+         * Take oldest event
+         * @param e receives event
+         * @return false if none
+         */
+        inline bool next(event &e) { return events.pop(e); }
+
+        /**
+         * Debounced state of a pin
+         * @tparam port port number, 1..8
+         * @param pin bit number
+         * @return true if active
+         */
+        template <u8 port>
+        inline bool active(u8 pin) {
+            return ((level[port - 1] ^ invert[port - 1]) >> pin) & 1u;
+        }
+
+      private:
+        static constexpr u16 base(u8 port) {
+            return 0x200 + 0x20 * ((port - 1) / 2) + ((port - 1) & 1);
+        }
+
+        /**
+         * Set edge against current level and unmask. An edge that came
+         * while the interrupt was off is turned into a pending flag.
+         */
+        template <u8 port>
+        inline void rearm(u8 pins, u8 in) {
+            GPIO::port_int<base(port)> p;
+            u8 &                       l = level[port - 1];
+            l                            = (l & ~pins) | (in & pins);
+            p.IES = (p.IES.get() & ~pins) | (in & pins);
+            p.IFG &= ~pins;
+            p.IE |= pins;
+            u8 moved = (p.IN.get() ^ in) & pins;
+            if (moved)
+                p.IFG |= moved;
+        }
+
+        template <u8 port>
+        inline void resample() {
+            u8 pins = due[port - 1];
+            if (pins) {
+                GPIO::port_int<base(port)> p;
+                u8                         in     = p.IN.get();
+                u8                         active = in ^ invert[port - 1];
+                u8 changed = (in ^ level[port - 1]) & pins;
+                for (u8 bit = 0; changed; bit++, changed >>= 1) {
+                    if (!(changed & 1u))
+                        continue;
+                    u8    pin = 8 * (port - 1) + bit;
+                    event e   = {pin, (u8)((active >> bit) & 1u), stamp[pin]};
+                    if (!events.push(e))
+                        dropped++;
+                }
+                rearm<port>(pins, in);
+            }
+            if constexpr (port < 8)
+                resample<port + 1>();
+        }
+    };
+}  // namespace MSP430::Driver::Debounce
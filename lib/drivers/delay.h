@@ -0,0 +1,221 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "clock.h"
+#include "imath.h"
+#include "power.h"
+#include "timer.h"
+
+/**
+ * Delays are computed at compile time from these frequencies, so define
+ * them per target to match the clock setup (e.g. with
+ * `TARGET_COMPILE_DEFINITIONS(... MSP430_MCLK_HZ=8000000)`, as
+ * CMakeLists.txt does for every target leaving the reset clock). Defaults
+ * are reset values: MCLK = DCO 8 MHz / 8, ACLK from 32768 Hz crystal.
+ */
+#ifndef MSP430_MCLK_HZ
+#define MSP430_MCLK_HZ 1000000
+#endif
+
+#ifndef MSP430_ACLK_HZ
+#define MSP430_ACLK_HZ 32768
+#endif
+
+/** Delays from this length up sleep in LPM3 instead of spinning */
+#ifndef MSP430_DELAY_SLEEP_US
+#define MSP430_DELAY_SLEEP_US 1000
+#endif
+
+/** Timer (base address, capture register count) used for sleeping delays */
+#ifndef MSP430_DELAY_TIMER
+#define MSP430_DELAY_TIMER 0x440, 2
+#endif
+
+namespace MSP430::Delay {
+    static constexpr u32 MCLK_HZ  = MSP430_MCLK_HZ;
+    static constexpr u32 ACLK_HZ  = MSP430_ACLK_HZ;
+    static constexpr u32 SLEEP_US = MSP430_DELAY_SLEEP_US;
+
+    /** Shortest delay done with a counting loop */
+    static constexpr u32 LOOP_MIN = 32;
+    /** Longest delay of one counting loop. Count stays below `0xFFFF`,
+     * which would be a 1-cycle constant generator load. */
+    static constexpr u32 LOOP_MAX = 2 + 3 * 0xFFFEul;
+
+    /**
+     * Busy wait for exactly `N` CPU cycles, as a compile-time selected
+     * sequence: a `mov #k, Rn; 1: dec Rn; jnz 1b` loop (2 + 3k cycles)
+     * topped up with `jmp` (2 cycles) and `nop` (1 cycle). Exact when code
+     * runs from cache or without FRAM wait states; interrupts stretch it.
+     * @tparam N cycles
+     */
+    template <u32 N>
+    inline void delay_cycles() {
+        if constexpr (N == 0) {
+        } else if constexpr (N == 1) {
+            __asm__ volatile("nop");
+        } else if constexpr (N < LOOP_MIN) {
+            __asm__ volatile("jmp 1f\n1:");
+            delay_cycles<N - 2>();
+        } else if constexpr (N <= LOOP_MAX) {
+            u16 r;
+            __asm__ volatile("mov.w %1, %0\n1:\n\tdec.w %0\n\tjnz 1b"
+                             : "=&r"(r)
+                             : "i"((u16)((N - 2) / 3)));
+            delay_cycles<(N - 2) % 3>();
+        } else {
+            delay_cycles<LOOP_MAX>();
+            delay_cycles<N - LOOP_MAX>();
+        }
+    }
+
+    /**
+     * Timer compare sleeper for long delays. The timer counts ACLK and
+     * keeps running between delays, so it also serves as a time base. CCR0
+     * wakes the CPU from LPM3, its vector must forward to `isr()`:
+     *
+     *     IRQ_HANDLER(TA3_CCR0) { MSP430::Delay::timer::isr(); }
+     *
+     * @tparam addr base address of timer
+     * @tparam ccrCount capture register count for this specific timer
+     */
+    template <u16 addr, u8 ccrCount>
+    struct sleeper {
+        typedef Driver::Timer::TA<addr, ccrCount> TA;
+
+        /**
+         * Start the timer unless already running
+         */
+        static inline void start() {
+            TA t;
+            if (!(t.CTL || TA::MODE_M)) {
+                t.CTL = TA::TBCLR;
+                t.CTL = TA::CLK_A | TA::DIV_1 | TA::CONT;
+            }
+        }
+
+        /**
+         * Current count, a free-running ACLK time base once started. ACLK
+         * is asynchronous to MCLK, so a single read may catch the counter
+         * mid-update; it is read until two reads agree.
+         */
+        static inline u16 now() {
+            TA  t;
+            u16 a = t.R.get();
+            u16 b;
+            do {
+                b = a;
+                a = t.R.get();
+            } while (a != b);
+            return a;
+        }
+
+        /**
+         * Sleep for a number of ACLK ticks, in the deepest level
+         * `Power::deepest()` allows but at most LPM3, the timer needs
+         * ACLK. SMCLK requests thus keep LPM1, `NEED::CPU` keeps the CPU
+         * polling. Other interrupts wake the CPU only for their handlers.
+         * Interrupt enable state is restored on return.
+         * @param ticks ACLK periods
+         */
+        static NOINLINE void sleep(u32 ticks) {
+            TA     t;
+            atomic g;
+            start();
+            while (ticks) {
+                u16 step = ticks > 0x8000 ? 0x8000 : (u16)ticks;
+                ticks -= step;
+                t.template ccr<0>()  = now() + step;
+                t.template cctl<0>() = TA::CCIE;
+                // GIE and LPM bits are set by one instruction, so a wake-up
+                // between the check and sleeping cannot be lost
+                while (t.template cctl<0>() || TA::CCIE) {
+                    switch (Power::deepest()) {
+                        case Power::LEVEL::ACTIVE: enable_interrupts(); break;
+                        case Power::LEVEL::LPM0:
+                        case Power::LEVEL::LPM1:
+                            set_low_power(POWER::MODE1);
+                            break;
+                        default: set_low_power(POWER::MODE3);
+                    }
+                    disable_interrupts();
+                }
+            }
+        }
+
+        /**
+         * Interrupt handler body: ends the sleep
+         */
+        static inline void isr() {
+            TA t;
+            t.template cctl<0>() = 0;
+            SR::clear_on_exit(0xF0);
+        }
+    };
+
+    typedef sleeper<MSP430_DELAY_TIMER> timer;
+
+    /**
+     * Wait `US` microseconds: exact busy wait below `MSP430_DELAY_SLEEP_US`,
+     * LPM3 sleep on `timer` (ACLK resolution) from there up.
+     * @tparam US microseconds
+     */
+    template <u32 US>
+    inline void delay_us() {
+        if constexpr (US >= SLEEP_US) {
+            constexpr u32 ticks =
+                ((unsigned long long)US * ACLK_HZ + 999999) / 1000000;
+            timer::sleep(ticks);
+        } else {
+            constexpr u32 cycles =
+                ((unsigned long long)US * MCLK_HZ + 999999) / 1000000;
+            delay_cycles<cycles>();
+        }
+    }
+
+    /**
+     * Busy wait for about `cycles` CPU cycles, 3 per loop step
+     */
+    static inline void spin(u32 cycles) {
+        u32 n = Math::div<3>(cycles);
+        while (n) {
+            u16 k = n > 0xFFFE ? 0xFFFE : (u16)n;
+            n -= k;
+            __asm__ volatile("1:\n\tdec.w %0\n\tjnz 1b" : "+r"(k));
+        }
+    }
+
+    /**
+     * Wait `us` microseconds with clock frequencies measured at run time
+     * (`Clock::dco_trim`), for when MCLK is not known at compile time.
+     * Below `MSP430_DELAY_SLEEP_US` it spins, about 100 cycles longer than
+     * asked for; from there up it sleeps like `delay_us<US>()`.
+     * @param f measured frequencies, e.g. `FR5994::clocks`
+     * @param us microseconds
+     */
+    inline void delay_us(const Driver::Clock::frequency &f, u32 us) {
+        using Math::div, Driver::MPY32::mulhi;
+        // Clocks per microsecond in Q16: f * 2^16 / 10^6
+        if (us >= SLEEP_US)
+            timer::sleep(mulhi(us, div<15625>(f.aclk << 10) << 16));
+        else
+            spin(mulhi(us << 16, div<15625>(f.mclk << 6)));
+    }
+
+    /**
+     * Wait `MS` milliseconds, see `delay_us()`
+     * @tparam MS milliseconds
+     */
+    template <u32 MS>
+    inline void delay_ms() {
+        delay_us<MS * 1000>();
+    }
+}  // namespace MSP430::Delay
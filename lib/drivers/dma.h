@@ -0,0 +1,184 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Driver::DMA {
+    using MSP430::Tools::IOREG;
+    using MSP430::Tools::IOREG20;
+
+    /**
+     * DMA trigger sources (DMAxTSEL), common to all channels
+     */
+    enum class TRIGGER : u8 {
+        DMAREQ   = 0,   //!< Software trigger (DMAREQ bit)
+        TA0CCR0  = 1,   //!< TA0CCR0 CCIFG
+        TA0CCR2  = 2,   //!< TA0CCR2 CCIFG
+        TA1CCR0  = 3,   //!< TA1CCR0 CCIFG
+        TA1CCR2  = 4,   //!< TA1CCR2 CCIFG
+        TA2CCR0  = 5,   //!< TA2CCR0 CCIFG
+        TA3CCR0  = 6,   //!< TA3CCR0 CCIFG
+        TB0CCR0  = 7,   //!< TB0CCR0 CCIFG
+        TB0CCR2  = 8,   //!< TB0CCR2 CCIFG
+        TA4CCR0  = 9,   //!< TA4CCR0 CCIFG
+        UCA0RX   = 14,  //!< eUSCI_A0 receive
+        UCA0TX   = 15,  //!< eUSCI_A0 transmit
+        UCA1RX   = 16,  //!< eUSCI_A1 receive
+        UCA1TX   = 17,  //!< eUSCI_A1 transmit
+        ADC12    = 26,  //!< ADC12_B end of conversion
+        LEA      = 27,  //!< LEA ready
+        MPY      = 29,  //!< MPY32 ready
+        PREVIOUS = 30,  //!< DMAIFG of previous channel
+        DMAE0    = 31,  //!< External trigger
+    };
+
+    /**
+     * DMA transfer modes (DMADT)
+     */
+    enum class TRANSFER : u16 {
+        SINGLE          = 0b000 << 12,  //!< Single transfer
+        BLOCK           = 0b001 << 12,  //!< Block transfer
+        BURST           = 0b010 << 12,  //!< Burst-block transfer
+        REPEATED_SINGLE = 0b100 << 12,  //!< Repeated single transfer
+        REPEATED_BLOCK  = 0b101 << 12,  //!< Repeated block transfer
+        REPEATED_BURST  = 0b110 << 12,  //!< Repeated burst-block transfer
+    };
+
+    /**
+     * Single DMA channel
+     * @tparam addr base address of DMA controller
+     * @tparam nr channel number
+     */
+    template <u16 addr, u8 nr>
+    struct channel {
+        static_assert(nr < 6);
+
+        enum CTLe : u16 {
+            DT_M = 0b111 << 12,  //!< Transfer mode mask
+
+            DSTINCR_M = 0b11 << 10,  //!< Destination increment mask
+            DST_FIX   = 0b00 << 10,  //!< Destination address is unchanged
+            DST_DEC   = 0b10 << 10,  //!< Destination address is decremented
+            DST_INC   = 0b11 << 10,  //!< Destination address is incremented
+
+            SRCINCR_M = 0b11 << 8,  //!< Source increment mask
+            SRC_FIX   = 0b00 << 8,  //!< Source address is unchanged
+            SRC_DEC   = 0b10 << 8,  //!< Source address is decremented
+            SRC_INC   = 0b11 << 8,  //!< Source address is incremented
+
+            DSTBYTE = 1 << 7,  //!< Destination is byte (otherwise word)
+            SRCBYTE = 1 << 6,  //!< Source is byte (otherwise word)
+            LEVEL   = 1 << 5,  //!< Level-sensitive trigger (otherwise edge)
+            EN      = 1 << 4,  //!< Channel enable
+            IFG     = 1 << 3,  //!< Transfer complete interrupt flag
+            IE      = 1 << 2,  //!< Transfer complete interrupt enable
+            ABORT   = 1 << 1,  //!< Transfer interrupted by NMI
+            REQ     = 1 << 0,  //!< Software request, starts transfer
+        };
+
+        IOREG<u16, addr + 0x10 + 0x10 * nr> CTL;
+        IOREG20<addr + 0x12 + 0x10 * nr>    SA;
+        IOREG20<addr + 0x16 + 0x10 * nr>    DA;
+        IOREG<u16, addr + 0x1A + 0x10 * nr> SZ;
+
+        /**
+         * Select trigger of channel. Shares `DMACTLx` with the sibling
+         * channel, so it is a read-modify-write.
+         * @param t trigger source
+         */
+        inline void set_trigger(TRIGGER t) {
+            IOREG<u16, addr + 2 * (nr / 2)> tsel;
+            if constexpr (nr % 2 == 0) {
+                tsel.mask_set(0xFF00, (u16)t);
+            } else {
+                tsel.mask_set(0x00FF, (u16)t << 8);
+            }
+        }
+
+        /**
+         * Program whole transfer. Channel is left disabled, call `enable()` or
+         * `start()` afterwards.
+         * @param src source address (20-bit)
+         * @param dst destination address (20-bit)
+         * @param size number of transfers
+         * @param mode transfer mode
+         * @param flags combination of `DST_*`, `SRC_*`, `*BYTE`, `IE` bits
+         * @param t trigger source
+         */
+        inline void setup(const volatile void *src, volatile void *dst,
+                          u16 size, TRANSFER mode, u16 flags,
+                          TRIGGER t = TRIGGER::DMAREQ) {
+            CTL = 0;
+            set_trigger(t);
+            SA = src;
+            DA = dst;
+            SZ = size;
+            CTL = (u16)mode | flags;
+        }
+
+        /**
+         * Arm channel, so it reacts on next trigger
+         */
+        inline void enable() { CTL |= EN; }
+
+        /**
+         * Disarm channel
+         */
+        inline void disable() { CTL &= ~EN; }
+
+        /**
+         * Arm channel and trigger it by software. Block transfers halt the
+         * CPU until finished, so on return the data is already moved.
+         */
+        inline void start() { CTL |= EN | REQ; }
+
+        /**
+         * Check if channel finished the transfer, clear the flag if so
+         * @return
+         */
+        inline bool done() {
+            if (CTL || IFG) {
+                CTL &= ~IFG;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * DMA controller
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct dma {
+        enum CTL4e : u16 {
+            RMWDIS     = 1 << 2,  //!< Do not interrupt CPU read-modify-write
+            ROUNDROBIN = 1 << 1,  //!< Rotate channel priorities
+            ENNMI      = 1 << 0,  //!< NMI aborts transfer
+        };
+
+        IOREG<u16, addr + 0x00> CTL0;
+        IOREG<u16, addr + 0x02> CTL1;
+        IOREG<u16, addr + 0x04> CTL2;
+        IOREG<u16, addr + 0x08> CTL4;
+        IOREG<u16, addr + 0x0E> IV;
+
+        /**
+         * Return channel accessor.
+         * @tparam nr channel number, compile-time checked
+         * @return accessor
+         */
+        template <u8 nr>
+        inline channel<addr, nr> ch() {
+            channel<addr, nr> c;
+            return c;
+        }
+    };
+}  // namespace MSP430::Driver::DMA
@@ -0,0 +1,354 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "imath.h"
+#include "mpy32.h"
+
+/**
+ * Block-based fixed-point signal processing. Samples are Q15 (`i16`), as
+ * delivered by `ADC12::stream` in signed mode. A pipeline is a compile-time
+ * chain of stages, each processing a block in place and returning the new
+ * block length (decimators shorten it):
+ *
+ *     using chain = DSP::pipeline<DSP::cic<4, 3>,           // /4
+ *                                 DSP::halfband<BLOCK / 4>,  // /2
+ *                                 DSP::biquad<lowpass>,
+ *                                 DSP::rms<16, true>,        // /16
+ *                                 DSP::threshold<8000, 6000, on_level>>;
+ *     chain pipe;
+ *     ...
+ *     if (i16 *b = stream.take())
+ *         pipe.process(b, BLOCK);
+ *
+ * With `MSP430_DSP_MPY32` defined, multiply-accumulate loops keep their
+ * accumulator in the MPY32 unit instead of doing one protected multiply per
+ * product. Pipelines must then run outside interrupt handlers, and handlers
+ * must not multiply while a pipeline may run.
+ */
+namespace MSP430::DSP {
+    namespace Detail {
+#ifdef MSP430_DSP_MPY32
+        /** Multiply-accumulate on MPY32 */
+        struct mac {
+            Driver::MPY32::mpy32<0x4C0> hw;
+
+            inline void first(i16 a, i16 b) { hw.macs_first(a, b); }
+            inline void add(i16 a, i16 b) { hw.macs(a, b); }
+            inline i32  result() { return hw.result(); }
+        };
+#else
+        /** Multiply-accumulate in CPU registers */
+        struct mac {
+            i32 acc;
+
+            inline void first(i16 a, i16 b) { acc = (i32)a * b; }
+            inline void add(i16 a, i16 b) { acc += (i32)a * b; }
+            inline i32  result() { return acc; }
+        };
+#endif
+
+        static constexpr u8 log2(u16 v) {
+            u8 r = 0;
+            while (v >>= 1)
+                r++;
+            return r;
+        }
+
+        /** Saturate to Q15 */
+        static inline i16 sat(i32 v) {
+            if (v > 32767)
+                return 32767;
+            if (v < -32768)
+                return -32768;
+            return (i16)v;
+        }
+    }  // namespace Detail
+
+    /**
+     * Cascaded integrator-comb decimator. Multiplier-free, gain `R^ORDER` is
+     * removed by a shift, so passband level is kept.
+     * @tparam R decimation ratio, power of 2
+     * @tparam ORDER number of integrator/comb pairs
+     */
+    template <u8 R, u8 ORDER>
+    struct cic {
+        static_assert(R >= 2 && (R & (R - 1)) == 0, "R must be power of 2");
+        static constexpr u8 SHIFT = Detail::log2(R) * ORDER;
+        static_assert(SHIFT + 16 <= 32, "register growth exceeds 32 bits");
+
+        u32 integ[ORDER];
+        u32 comb[ORDER];
+        u8  phase;
+
+        void reset() {
+            for (u8 k = 0; k < ORDER; k++)
+                integ[k] = comb[k] = 0;
+            phase = 0;
+        }
+
+        u16 process(i16 *buf, u16 n) {
+            u16 out = 0;
+            for (u16 i = 0; i < n; i++) {
+                u32 v = (u32)(i32)buf[i];
+                for (u8 k = 0; k < ORDER; k++)
+                    v = integ[k] += v;
+                if (++phase < R)
+                    continue;
+                phase = 0;
+                for (u8 k = 0; k < ORDER; k++) {
+                    u32 d   = v - comb[k];
+                    comb[k] = v;
+                    v       = d;
+                }
+                buf[out++] = (i16)((i32)v >> SHIFT);
+            }
+            return out;
+        }
+    };
+
+    /**
+     * 11-tap half-band FIR decimating by 2. Flat within 0.2 dB up to 0.1 fs,
+     * at least 33 dB down from 0.4 fs (input rate). Every second tap is
+     * zero, so it costs 7 products per output sample.
+     * @tparam N largest block length passed to `process()`
+     */
+    template <u16 N>
+    struct halfband {
+        static constexpr u8  TAPS   = 11;
+        static constexpr u8  HIST   = TAPS - 1;
+        static constexpr i16 H0     = 56;
+        static constexpr i16 H2     = -1182;
+        static constexpr i16 H4     = 9316;
+        static constexpr i16 CENTER = 16384;
+
+        i16 line[HIST + N];  //!< history followed by current block
+        u8  phase;           //!< index of first input producing output
+
+        void reset() {
+            for (u8 k = 0; k < HIST; k++)
+                line[k] = 0;
+            phase = 0;
+        }
+
+        u16 process(i16 *buf, u16 n) {
+            for (u16 i = 0; i < n; i++)
+                line[HIST + i] = buf[i];
+
+            u16 out = 0;
+            u16 i   = phase;
+            for (; i < n; i += 2) {
+                const i16 *x = line + i;
+                Detail::mac m;
+                m.first(x[0], H0);
+                m.add(x[10], H0);
+                m.add(x[2], H2);
+                m.add(x[8], H2);
+                m.add(x[4], H4);
+                m.add(x[6], H4);
+                m.add(x[5], CENTER);
+                buf[out++] = Detail::sat((m.result() + (1l << 14)) >> 15);
+            }
+            phase = i - n;
+
+            for (u8 k = 0; k < HIST; k++)
+                line[k] = line[n + k];
+            return out;
+        }
+    };
+
+    /**
+     * Second-order section, Q14 coefficients. Feedback coefficients have
+     * their sign flipped (CMSIS convention):
+     * `y = b0 x + b1 x[-1] + b2 x[-2] + a1 y[-1] + a2 y[-2]`
+     */
+    struct section {
+        i16 b0, b1, b2, a1, a2;
+    };
+
+    /**
+     * Direct form I biquad cascade
+     *
+     *     constexpr DSP::section lowpass[] = {
+     *         {1105, 2210, 1105, 18727, -6763}};  // Butterworth, 0.1 fs
+     *
+     * @tparam C array of sections with static storage
+     */
+    template <const auto &C>
+    struct biquad {
+        static constexpr u8 SECTIONS = sizeof(C) / sizeof(section);
+
+        struct state {
+            i16 x1, x2, y1, y2;
+        } s[SECTIONS];
+
+        void reset() {
+            for (u8 k = 0; k < SECTIONS; k++)
+                s[k] = {};
+        }
+
+        u16 process(i16 *buf, u16 n) {
+            for (u16 i = 0; i < n; i++) {
+                i16 x = buf[i];
+                for (u8 k = 0; k < SECTIONS; k++) {
+                    const section &c  = C[k];
+                    state &        st = s[k];
+                    Detail::mac    m;
+                    m.first(c.b0, x);
+                    m.add(c.b1, st.x1);
+                    m.add(c.b2, st.x2);
+                    m.add(c.a1, st.y1);
+                    m.add(c.a2, st.y2);
+                    i16 y = Detail::sat((m.result() + (1l << 13)) >> 14);
+                    st.x2 = st.x1;
+                    st.x1 = x;
+                    st.y2 = st.y1;
+                    st.y1 = y;
+                    x     = y;
+                }
+                buf[i] = x;
+            }
+            return n;
+        }
+    };
+
+    /**
+     * RMS and peak over consecutive windows. `level`, `peak` and `fresh`
+     * are updated at the end of each window.
+     * @tparam WINDOW window length, power of 2
+     * @tparam EMIT replace block with one `level` sample per window, so
+     * following stages work on the envelope; otherwise pass samples through
+     */
+    template <u16 WINDOW, bool EMIT = false>
+    struct rms {
+        static_assert(WINDOW >= 2 && (WINDOW & (WINDOW - 1)) == 0,
+                      "WINDOW must be power of 2");
+        static constexpr u8 SHIFT = Detail::log2(WINDOW);
+
+        u32           acc;
+        u16           count;
+        u16           max;
+        u16           level;  //!< RMS of last window, Q15
+        u16           peak;   //!< largest magnitude in last window, Q15
+        volatile bool fresh;  //!< set on new `level`, clear when consumed
+
+        void reset() {
+            acc = count = max = level = peak = 0;
+            fresh                            = false;
+        }
+
+        u16 process(i16 *buf, u16 n) {
+            u16 out = 0;
+            for (u16 i = 0; i < n; i++) {
+                i16 x = buf[i];
+                u16 a = x < 0 ? (u16)0 - (u16)x : (u16)x;
+                if (a > max)
+                    max = a;
+                Detail::mac m;
+                m.first(x, x);
+                acc += (u32)m.result() >> SHIFT;
+                if (++count < WINDOW)
+                    continue;
+                level = Math::isqrt(acc);
+                peak  = max;
+                fresh = true;
+                acc = count = max = 0;
+                if constexpr (EMIT)
+                    buf[out++] = (i16)(level > 32767 ? 32767 : level);
+            }
+            return EMIT ? out : n;
+        }
+    };
+
+    /**
+     * Level detector with hysteresis. Calls `Event(true)` when magnitude
+     * rises to `HIGH`, `Event(false)` when it falls to `LOW`. Samples pass
+     * through.
+     * @tparam HIGH rising threshold, Q15
+     * @tparam LOW falling threshold, Q15, below `HIGH`
+     * @tparam Event callback
+     */
+    template <u16 HIGH, u16 LOW, void (*Event)(bool)>
+    struct threshold {
+        static_assert(LOW < HIGH);
+
+        bool above;
+
+        void reset() { above = false; }
+
+        u16 process(i16 *buf, u16 n) {
+            for (u16 i = 0; i < n; i++) {
+                i16 x = buf[i];
+                u16 a = x < 0 ? (u16)0 - (u16)x : (u16)x;
+                if (!above && a >= HIGH) {
+                    above = true;
+                    Event(true);
+                } else if (above && a <= LOW) {
+                    above = false;
+                    Event(false);
+                }
+            }
+            return n;
+        }
+    };
+
+    /**
+     * Compile-time chain of stages. A stage is any type with
+     * `u16 process(i16 *buf, u16 n)` and `void reset()`. Stages are plain
+     * members, so a global pipeline keeps all state in `.bss`.
+     */
+    template <typename... Stages>
+    struct pipeline;
+
+    template <>
+    struct pipeline<> {
+        inline u16  process(i16 *, u16 n) { return n; }
+        inline void reset() {}
+    };
+
+    template <typename Head, typename... Tail>
+    struct pipeline<Head, Tail...> {
+        Head              head;
+        pipeline<Tail...> tail;
+
+        /**
+         * Run block through all stages
+         * @param buf samples, overwritten with output
+         * @param n number of samples
+         * @return number of output samples in `buf`
+         */
+        inline u16 process(i16 *buf, u16 n) {
+            n = head.process(buf, n);
+            return n ? tail.process(buf, n) : 0;
+        }
+
+        /**
+         * Clear state of all stages
+         */
+        inline void reset() {
+            head.reset();
+            tail.reset();
+        }
+
+        /**
+         * Access stage by position
+         * @tparam i stage index, compile-time checked
+         * @return stage
+         */
+        template <u8 i>
+        inline auto &stage() {
+            static_assert(i <= sizeof...(Tail), "no such stage");
+            if constexpr (i == 0)
+                return head;
+            else
+                return tail.template stage<i - 1>();
+        }
+    };
+}  // namespace MSP430::DSP
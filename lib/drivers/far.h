@@ -0,0 +1,195 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "dma.h"
+
+/**
+ * Containers for tables living above 64 KiB (in `FRAM_HI`).
+ *
+ * Tables are declared like
+ *
+ *     far_array<u16, 1024> waveform DATA_PERSISTENT_HIGH = {{...}};
+ *
+ * and every access goes through explicit 20-bit (`MOVX`/`.A`) instructions,
+ * independent of what the compiler chooses for generic pointers.
+ */
+namespace MSP430::Far {
+    using MSP430::Driver::DMA::TRANSFER;
+
+    /**
+     * Read single element through 20-bit address
+     * @tparam T element type, 1, 2 or 4 bytes long; bits are copied, so
+     * `float` works too
+     * @param p address of element
+     * @return value
+     */
+    template <typename T>
+    inline T read(const T *p) {
+        static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4);
+        if constexpr (sizeof(T) == 1) {
+            T v;
+            __asm__ volatile("movx.b @%1, %0" : "=r"(v) : "r"(p), "m"(*p));
+            return v;
+        } else if constexpr (sizeof(T) == 2) {
+            T v;
+            __asm__ volatile("movx.w @%1, %0" : "=r"(v) : "r"(p), "m"(*p));
+            return v;
+        } else {
+            u16 lo, hi;
+            __asm__ volatile("movx.w 0(%2), %0\n\t"
+                             "movx.w 2(%2), %1"
+                             : "=r"(lo), "=r"(hi)
+                             : "r"(p), "m"(*p));
+            return __builtin_bit_cast(T, ((u32)hi << 16) | lo);
+        }
+    }
+
+    /**
+     * Sequential reader. The address is kept in a register and advanced by
+     * post-increment addressing (`@Rn+`), so each step is one instruction.
+     * @tparam T element type, 1, 2 or 4 bytes long
+     */
+    template <typename T>
+    struct far_iterator {
+        const T *p;
+
+        /**
+         * Read current element, do not advance
+         * @return value
+         */
+        inline T operator*() const { return read(p); }
+
+        /**
+         * Read current element and advance to the next one
+         * @return value
+         */
+        inline T next() {
+            static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4);
+            if constexpr (sizeof(T) == 1) {
+                T v;
+                __asm__ volatile("movx.b @%0+, %1" : "+r"(p), "=r"(v));
+                return v;
+            } else if constexpr (sizeof(T) == 2) {
+                T v;
+                __asm__ volatile("movx.w @%0+, %1" : "+r"(p), "=r"(v));
+                return v;
+            } else {
+                u16 lo, hi;
+                __asm__ volatile("movx.w @%0+, %1\n\t"
+                                 "movx.w @%0+, %2"
+                                 : "+r"(p), "=r"(lo), "=r"(hi));
+                return __builtin_bit_cast(T, ((u32)hi << 16) | lo);
+            }
+        }
+
+        inline far_iterator &operator++() {
+            ++p;
+            return *this;
+        }
+
+        inline bool operator!=(const far_iterator &o) const {
+            return p != o.p;
+        }
+
+        inline bool operator==(const far_iterator &o) const {
+            return p == o.p;
+        }
+    };
+
+    /**
+     * Non-owning view of a far table
+     * @tparam T element type
+     */
+    template <typename T>
+    struct far_span {
+        const T *ptr;
+        u16      len;
+
+        inline u16             size() const { return len; }
+        inline T               operator[](u16 i) const { return read(ptr + i); }
+        inline far_iterator<T> begin() const { return {ptr}; }
+        inline far_iterator<T> end() const { return {ptr + len}; }
+
+        /**
+         * Sub-view of the table
+         * @param from first element
+         * @param count number of elements
+         * @return view
+         */
+        inline far_span sub(u16 from, u16 count) const {
+            return {ptr + from, count};
+        }
+
+        /**
+         * Copy whole view by CPU, with pointer kept in a register
+         * @param dst destination buffer, at least `size()` elements long
+         */
+        inline void copy_to(T *dst) const {
+            far_iterator<T> it{ptr};
+            for (u16 i = 0; i < len; i++)
+                dst[i] = it.next();
+        }
+
+        /**
+         * Copy whole view by a DMA block transfer, triggered by software.
+         * The CPU is halted until the block is moved, so on return the data
+         * is already in place.
+         * @tparam Channel DMA channel type (from `dma.ch<n>()`)
+         * @param dst destination buffer, at least `size()` elements long
+         * @param ch DMA channel to use
+         */
+        template <typename Channel>
+        inline void dma_to(T *dst, Channel ch) const {
+            constexpr bool bytes = sizeof(T) == 1;
+            static_assert(bytes || sizeof(T) % 2 == 0);
+            constexpr u16 flags =
+                Channel::SRC_INC | Channel::DST_INC
+                | (bytes ? (Channel::SRCBYTE | Channel::DSTBYTE) : 0);
+            ch.setup(ptr, dst, bytes ? len : len * (sizeof(T) / 2),
+                     TRANSFER::BLOCK, flags);
+            ch.start();
+        }
+    };
+
+    /**
+     * Fixed-size far table. It is an aggregate, so it can be initialised
+     * in place; place it with `DATA_PERSISTENT_HIGH`.
+     * @tparam T element type
+     * @tparam N number of elements
+     */
+    template <typename T, u16 N>
+    struct far_array {
+        T data[N];
+
+        static constexpr u16 size() { return N; }
+
+        inline T operator[](u16 i) const { return read(data + i); }
+        inline far_iterator<T> begin() const { return {data}; }
+        inline far_iterator<T> end() const { return {data + N}; }
+        inline far_span<T>     view() const { return {data, N}; }
+
+        /**
+         * Write single element through 20-bit address
+         * @param i index
+         * @param v new value
+         */
+        inline void put(u16 i, T v) {
+            static_assert(sizeof(T) <= 2, "use view/DMA for wide elements");
+            if constexpr (sizeof(T) == 1) {
+                __asm__ volatile("movx.b %1, 0(%0)" ::"r"(data + i), "r"(v)
+                                 : "memory");
+            } else {
+                __asm__ volatile("movx.w %1, 0(%0)" ::"r"(data + i), "r"(v)
+                                 : "memory");
+            }
+        }
+    };
+}  // namespace MSP430::Far
@@ -0,0 +1,323 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "imath.h"
+
+/**
+ * Formatted output without `printf`. The format string is a template
+ * argument, parsed at compile time into a sequence of calls: literal text
+ * becomes one `write()` of a constant, each field a call to its emitter.
+ *
+ *     Format::print<"adc {} mV, ctl {x4}, gain {q15.4}\r\n">(log, mv, r, g);
+ *
+ *     char line[32];
+ *     u16  n = Format::format<"t={}">(line, sizeof(line), t);
+ *
+ * Fields:
+ *   - `{}`: decimal for integers up to 32 bits, the character for `char`,
+ *     the string for `const char *`,
+ *   - `{x}`, `{xN}`: upper-case hex, `N` digits (default: 2 per byte of
+ *     the argument), leading zeros kept,
+ *   - `{qF}`, `{qF.D}`: signed fixed point with `F` fractional bits
+ *     (1..16), rounded to `D` decimals (1..4, default 3),
+ *   - `{{` and `}}` stand for `{` and `}`.
+ *
+ * A malformed field or an argument count that does not match the string
+ * is a compile error. Emitters are not inlined, one copy per sink type
+ * (per `F.D` for fixed point) serves all call sites, so a call site costs
+ * what the equivalent hand-written calls would. Decimal output uses
+ * `Math::utoa()`, no run-time division.
+ *
+ * A sink is any type with `put(char)` and `write(const char *, u16)`, like
+ * `span` or `Driver::UART::uart`.
+ */
+namespace MSP430::Format {
+    /**
+     * String literal as template argument
+     * @tparam N size including terminating zero
+     */
+    template <u16 N>
+    struct fixed_string {
+        char s[N];
+
+        constexpr fixed_string(const char (&in)[N]) {
+            for (u16 i = 0; i < N; i++)
+                s[i] = in[i];
+        }
+    };
+
+    /**
+     * Sink writing to a caller-supplied buffer, excess is cut off
+     */
+    struct span {
+        char *data;
+        u16   capacity;
+        u16   length;
+
+        inline void put(char c) {
+            if (length < capacity)
+                data[length++] = c;
+        }
+
+        inline void write(const char *s, u16 n) {
+            while (n--)
+                put(*s++);
+        }
+    };
+
+    namespace Detail {
+        enum class KIND : u8 { END, TEXT, DEC, HEX, FIXED };
+
+        /** Piece of format string, text `begin..end` or a field */
+        struct piece {
+            KIND kind;
+            u16  begin;
+            u16  end;
+            u16  next;      //!< position after piece
+            u8   width;     //!< `HEX`: digits, 0: by argument size
+            u8   frac;      //!< `FIXED`: fractional bits
+            u8   decimals;  //!< `FIXED`: decimals
+        };
+
+        /** Not constexpr: reaching it at compile time fails the build */
+        void format_error(const char *why);
+
+        static constexpr bool digit(char c) { return c >= '0' && c <= '9'; }
+
+        template <u16 N>
+        constexpr piece parse(const fixed_string<N> &f, u16 pos) {
+            const char *s = f.s;
+            const u16   n = N - 1;
+            piece       p = {KIND::END, pos, pos, pos, 0, 0, 0};
+            if (pos >= n)
+                return p;
+
+            p.kind = KIND::TEXT;
+            if ((s[pos] == '{' || s[pos] == '}') && s[pos + 1] == s[pos]) {
+                p.end  = pos + 1;
+                p.next = pos + 2;
+                return p;
+            }
+            if (s[pos] == '}')
+                format_error("single '}'");
+            if (s[pos] != '{') {
+                u16 i = pos;
+                while (i < n && s[i] != '{' && s[i] != '}')
+                    i++;
+                p.end = p.next = i;
+                return p;
+            }
+
+            u16 i  = pos + 1;
+            p.kind = KIND::DEC;
+            if (s[i] == 'x') {
+                p.kind = KIND::HEX;
+                for (i++; digit(s[i]); i++)
+                    p.width = 10 * p.width + (s[i] - '0');
+                if (p.width > 8)
+                    format_error("hex field wider than 8");
+            } else if (s[i] == 'q') {
+                p.kind     = KIND::FIXED;
+                p.decimals = 3;
+                for (i++; digit(s[i]); i++)
+                    p.frac = 10 * p.frac + (s[i] - '0');
+                if (s[i] == '.') {
+                    p.decimals = 0;
+                    for (i++; digit(s[i]); i++)
+                        p.decimals = 10 * p.decimals + (s[i] - '0');
+                }
+                if (p.frac < 1 || p.frac > 16)
+                    format_error("fixed point needs 1..16 fractional bits");
+                if (p.decimals < 1 || p.decimals > 4)
+                    format_error("fixed point needs 1..4 decimals");
+            }
+            if (s[i] != '}')
+                format_error("unknown field");
+            p.next = i + 1;
+            return p;
+        }
+
+        template <u16 N>
+        constexpr u8 fields(const fixed_string<N> &f) {
+            u8 count = 0;
+            for (piece p = parse(f, 0); p.kind != KIND::END;
+                 p       = parse(f, p.next))
+                if (p.kind != KIND::TEXT)
+                    count++;
+            return count;
+        }
+
+        template <u16 L>
+        struct chars {
+            char c[L];
+        };
+
+        /** Literal text `B..E` of a format string, stored once */
+        template <fixed_string F, u16 B, u16 E>
+        inline constexpr chars<E - B> text = [] {
+            chars<E - B> t = {};
+            for (u16 i = 0; i < E - B; i++)
+                t.c[i] = F.s[B + i];
+            return t;
+        }();
+
+        template <typename T>
+        struct pointer {
+            static constexpr bool value = false;
+        };
+
+        template <typename T>
+        struct pointer<T *> {
+            static constexpr bool value = true;
+        };
+
+        template <typename A, typename B>
+        struct same {
+            static constexpr bool value = false;
+        };
+
+        template <typename A>
+        struct same<A, A> {
+            static constexpr bool value = true;
+        };
+
+        template <typename Out>
+        NOINLINE void dec(Out &out, u32 v) {
+            char b[11];
+            out.write(b, Math::utoa(v, b));
+        }
+
+        template <typename Out>
+        NOINLINE void dec(Out &out, i32 v) {
+            char b[12];
+            out.write(b, Math::itoa(v, b));
+        }
+
+        template <typename Out>
+        NOINLINE void str(Out &out, const char *s) {
+            while (*s)
+                out.put(*s++);
+        }
+
+        template <typename Out>
+        NOINLINE void hex(Out &out, u32 v, u8 width) {
+            char b[8];
+            for (u8 i = width; i--; v >>= 4)
+                b[i] = "0123456789ABCDEF"[v & 0xF];
+            out.write(b, width);
+        }
+
+        static constexpr u16 pow10(u8 n) { return n ? 10 * pow10(n - 1) : 1; }
+
+        /**
+         * Fixed point: the fraction times `10^D` is done on MPY32, then
+         * rounded, carrying into the integer part
+         */
+        template <u8 FRAC, u8 D, typename Out>
+        NOINLINE void fixed(Out &out, i32 v) {
+            constexpr u16 SCALE = pow10(D);
+            constexpr u32 MASK  = (1ul << FRAC) - 1;
+
+            u32 m = v < 0 ? -(u32)v : (u32)v;
+            u32 i = m >> FRAC;
+            u32 f = Driver::MPY32::mul((u16)(m & MASK), SCALE);
+            f     = (f + (1ul << (FRAC - 1))) >> FRAC;
+            if (f >= SCALE) {
+                f -= SCALE;
+                i++;
+            }
+
+            char b[17];
+            u8   n = 0;
+            if (v < 0)
+                b[n++] = '-';
+            n += Math::utoa(i, b + n);
+            b[n++] = '.';
+            char d[4];
+            Math::digits4((u16)f, d);
+            for (u8 k = 4 - D; k < 4; k++)
+                b[n++] = d[k];
+            out.write(b, n);
+        }
+
+        template <typename Out, typename T>
+        inline void decimal(Out &out, T v) {
+            if constexpr (pointer<T>::value)
+                str(out, v);
+            else if constexpr (same<T, char>::value)
+                out.put(v);
+            else if constexpr ((T)-1 < (T)0)
+                dec(out, (i32)v);
+            else
+                dec(out, (u32)v);
+        }
+
+        template <fixed_string F, u16 pos, typename Out, typename... Args>
+        inline void emit(Out &out, Args... args);
+
+        template <fixed_string F, u16 pos, typename Out, typename A,
+                  typename... Rest>
+        inline void field(Out &out, A a, Rest... rest) {
+            constexpr piece p = parse(F, pos);
+            if constexpr (p.kind == KIND::DEC)
+                decimal(out, a);
+            else if constexpr (p.kind == KIND::HEX)
+                hex(out, (u32)a, p.width ? p.width : 2 * sizeof(A));
+            else
+                fixed<p.frac, p.decimals>(out, (i32)a);
+            emit<F, p.next>(out, rest...);
+        }
+
+        template <fixed_string F, u16 pos, typename Out, typename... Args>
+        inline void emit(Out &out, Args... args) {
+            constexpr piece p = parse(F, pos);
+            constexpr u16   n = p.end - p.begin;
+            if constexpr (p.kind == KIND::TEXT) {
+                if constexpr (n == 1)
+                    out.put(F.s[p.begin]);
+                else
+                    out.write(text<F, p.begin, p.end>.c, n);
+                emit<F, p.next>(out, args...);
+            } else if constexpr (p.kind != KIND::END) {
+                field<F, pos>(out, args...);
+            }
+        }
+    }  // namespace Detail
+
+    /**
+     * Format into a sink
+     * @tparam F format string
+     * @param out sink
+     * @param args one per field
+     */
+    template <fixed_string F, typename Out, typename... Args>
+    inline void print(Out &out, Args... args) {
+        static_assert(Detail::fields(F) == sizeof...(Args),
+                      "argument count does not match format");
+        Detail::emit<F, 0>(out, args...);
+    }
+
+    /**
+     * Format into a buffer, cut off to fit
+     * @tparam F format string
+     * @param buf buffer
+     * @param size buffer size, at least 1
+     * @param args one per field
+     * @return length, `buf` is zero-terminated
+     */
+    template <fixed_string F, typename... Args>
+    inline u16 format(char *buf, u16 size, Args... args) {
+        span s = {buf, (u16)(size - 1), 0};
+        print<F>(s, args...);
+        buf[s.length] = 0;
+        return s.length;
+    }
+}  // namespace MSP430::Format
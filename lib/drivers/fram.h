@@ -0,0 +1,57 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Driver::FRAM {
+    using MSP430::Tools::IOREG;
+
+    /**
+     * FRAM controller
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct frctl {
+        /** Highest MCLK that runs FRAM without wait states */
+        static constexpr u32 MAX_NO_WAIT_HZ = 8000000;
+        /** Highest MCLK of the device */
+        static constexpr u32 MAX_HZ = 16000000;
+
+        IOREG<u16, addr + 0x00> CTL0;
+        IOREG<u8, addr + 0x01>  CTL0_H;
+        IOREG<u16, addr + 0x04> GCCTL0;
+        IOREG<u16, addr + 0x06> GCCTL1;
+
+        /**
+         * Wait states needed for given MCLK
+         * @param mclk_hz MCLK frequency, at most `MAX_HZ` (measured values
+         * may be up to 1/32 above it)
+         * @return wait states; 0xFF for faster clocks, the device is not
+         * specified for them and `set_wait_states()` refuses them
+         */
+        static constexpr u8 wait_states(u32 mclk_hz) {
+            if (mclk_hz > MAX_HZ + MAX_HZ / 32)
+                return 0xFF;
+            return mclk_hz > MAX_NO_WAIT_HZ ? 1 : 0;
+        }
+
+        /**
+         * Set FRAM wait states. Must be raised *before* MCLK goes above
+         * 8 MHz, and may be lowered only after it went down.
+         * @param n wait states, 0..7; anything else is ignored
+         */
+        inline void set_wait_states(u8 n) {
+            if (n > 7)
+                return;
+            CTL0   = 0xA500 | (n << 4);
+            CTL0_H = 0;
+        }
+    };
+}  // namespace MSP430::Driver::FRAM
@@ -45,15 +45,22 @@ namespace MSP430::Driver::GPIO {
     /**
      * Generic simple I/O port interface
      * @tparam addr base address of device
+     * @tparam reg type of port: u8 for single port, u16 for port pair
      */
-    template <u16 addr>
+    template <u16 addr, typename reg = u8>
     struct port_simple {
+        /** Base address of port, for compile-time pin descriptions */
+        static constexpr u16 base = addr;
+
+        /** Register type of port */
+        typedef reg reg_type;
+
         /**
          * Each bit in each PxIN register reflects the value of the input signal
          at the corresponding I/O pin when the pin is configured as I/O
          function. These registers are read only.
          */
-        IOREG<u8, addr + 0x00> IN;
+        IOREG<reg, addr + 0x00> IN;
 
         /**
          * Each bit in each PxOUT register is the value to be output on the
@@ -64,7 +71,7 @@ namespace MSP430::Driver::GPIO {
          pullup or pulldown resistor are enabled; the corresponding bit in the
          PxOUT register selects pullup or pulldown.
          */
-        IOREG<u8, addr + 0x02> OUT;
+        IOREG<reg, addr + 0x02> OUT;
 
         /**
          * Each bit in each PxDIR register selects the direction of the
@@ -72,30 +79,30 @@ namespace MSP430::Driver::GPIO {
          PxDIR bits for I/O pins that are selected for other functions must be
          set as required by the other function. 0=IN 1=OUT
          */
-        IOREG<u8, addr + 0x04> DIR;
+        IOREG<reg, addr + 0x04> DIR;
 
         /**
          * Each bit in each PxREN register enables or disables the pullup or
          pulldown resistor of the corresponding I/O pin. The corresponding bit
          in the PxOUT register selects if the pin contains a pullup or pulldown.
          */
-        IOREG<u8, addr + 0x06> REN;
+        IOREG<reg, addr + 0x06> REN;
 
         /** Function Select Register0 */
-        IOREG<u8, addr + 0x0A> SEL0;
+        IOREG<reg, addr + 0x0A> SEL0;
 
-        /** /** Function Select Register1 */
-        IOREG<u8, addr + 0x0C> SEL1;
+        /** Function Select Register1 */
+        IOREG<reg, addr + 0x0C> SEL1;
 
         /** Function Select Register01 */
-        IOREG<u8, addr + 0x0E> SELC;
+        IOREG<reg, addr + 0x16> SELC;
 
-        void set_mode(MODE m, u8 pins);
-        void set_function(FUNCTION f, u8 pins);
+        void set_mode(MODE m, reg pins);
+        void set_function(FUNCTION f, reg pins);
     };
 
-    template <u16 addr>
-    inline void port_simple<addr>::set_mode(MODE m, u8 pins) {
+    template <u16 addr, typename reg>
+    inline void port_simple<addr, reg>::set_mode(MODE m, reg pins) {
         switch (m) {
             case MODE::OUT: {
                 DIR |= pins;
@@ -121,8 +128,8 @@ namespace MSP430::Driver::GPIO {
         }
     }
 
-    template <u16 addr>
-    inline void port_simple<addr>::set_function(FUNCTION f, u8 pins) {
+    template <u16 addr, typename reg>
+    inline void port_simple<addr, reg>::set_function(FUNCTION f, reg pins) {
         switch (f) {
             case FUNCTION::GPIO: {
                 SEL0 &= ~pins;
@@ -153,7 +160,12 @@ namespace MSP430::Driver::GPIO {
      */
     template <u16 addr>
     struct port_int : public port_simple<addr> {
-        IOREG<u8, addr + 0x16> IV;
+        /**
+         * Interrupt vector of port. Odd ports (P2, P4...) have it at the end
+         * of the shared port pair block.
+         */
+        IOREG<u16, (addr & ~1u) + ((addr & 1u) ? 0x1E : 0x0E)> IV;
+
         IOREG<u8, addr + 0x18> IES;
         IOREG<u8, addr + 0x1A> IE;
         IOREG<u8, addr + 0x1C> IFG;
@@ -175,4 +187,43 @@ namespace MSP430::Driver::GPIO {
         }
         IE |= pins;
     }
+
+    /**
+     * Pair of interrupt-generating I/O ports accessed as single 16-bit port
+     * (PA = P1/P2, PB = P3/P4, PC = P5/P6, PD = P7/P8). Lower port is in bits
+     * 0..7, upper port in bits 8..15, so a whole 16-bit pattern is written
+     * with one `mov.w`.
+     * @tparam addr base address of device (address of lower port)
+     */
+    template <u16 addr>
+    struct port_pair : public port_simple<addr, u16> {
+        static_assert((addr & 1u) == 0, "port pair must be word-aligned");
+
+        /** Interrupt vector of lower port */
+        IOREG<u16, addr + 0x0E> IV_LO;
+
+        /** Interrupt vector of upper port */
+        IOREG<u16, addr + 0x1E> IV_HI;
+
+        IOREG<u16, addr + 0x18> IES;
+        IOREG<u16, addr + 0x1A> IE;
+        IOREG<u16, addr + 0x1C> IFG;
+
+        void int_enable(EDGE e, u16 pins);
+        void int_disable(u16 pins);
+    };
+
+    template <u16 addr>
+    inline void port_pair<addr>::int_disable(u16 pins) {
+        IE &= ~pins;
+    }
+
+    template <u16 addr>
+    inline void port_pair<addr>::int_enable(EDGE e, u16 pins) {
+        switch (e) {
+            case EDGE::RISING: IES &= ~pins; break;
+            case EDGE::FALLING: IES |= pins; break;
+        }
+        IE |= pins;
+    }
 }  // namespace MSP430::Driver::GPIO
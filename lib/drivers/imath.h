@@ -0,0 +1,312 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "mpy32.h"
+
+/**
+ * Integer math for a CPU without divider:
+ *   - `div<D>()`, `mod<D>()`: division of `u16` or `u32` by a compile-time
+ *     constant, as a multiply-high by its reciprocal on MPY32, exact for
+ *     every dividend (Granlund-Montgomery),
+ *   - `div32()`: 32/16 division with 16-bit steps,
+ *   - `isqrt()`: integer square root,
+ *   - `sincos()`, `atan2()`: CORDIC on Q15 values. Angles are binary:
+ *     `i16` where 32768 is pi, so a full turn wraps around,
+ *   - `utoa()`, `itoa()`, `digits4()`: decimal digits with no run-time
+ *     division.
+ *
+ * MPY32 is used with interrupts disabled for a few cycles, so handlers may
+ * multiply. `src/MathBench.cpp` compares cycles with the libgcc routines.
+ */
+namespace MSP430::Math {
+    namespace Detail {
+        typedef __UINT64_TYPE__ u64;
+        using Driver::MPY32::mul, Driver::MPY32::mulhi;
+
+        static constexpr u8 log2_ceil(u32 v) {
+            u8 r = 0;
+            while (r < 32 && ((u64)1 << r) < v)
+                r++;
+            return r;
+        }
+
+        /**
+         * Reciprocal of `D` for `N`-bit dividends. The short form, `M` of
+         * `N` bits with `q = mulhi(n, M) >> S`, is taken when exact for all
+         * dividends; otherwise `M` is the low `N` bits of an `N + 1` bit
+         * multiplier and the missing top bit is added back.
+         */
+        template <typename T, u32 D>
+        struct reciprocal {
+            static_assert(D > 0, "division by zero");
+            static constexpr u8  N    = 8 * sizeof(T);
+            static constexpr u8  L    = log2_ceil(D);
+            static constexpr u8  NONE = 0xFF;
+            static constexpr u64 ONE  = 1;
+
+            static constexpr u64 up(u8 s) {
+                return ((ONE << (N + s)) + D - 1) / D;
+            }
+
+            static constexpr u8 find() {
+                for (u8 s = 0; s <= L; s++)
+                    if (up(s) < (ONE << N)
+                        && up(s) * D - (ONE << (N + s)) <= (ONE << s))
+                        return s;
+                return NONE;
+            }
+
+            static constexpr bool POW2  = (D & (D - 1)) == 0;
+            static constexpr bool SHORT = find() != NONE;
+            static constexpr u8   S     = SHORT ? find() : L;
+            static constexpr T    M =
+                SHORT ? (T)up(S) : (T)((ONE << N) * ((ONE << L) - D) / D + 1);
+        };
+
+        template <typename T, u32 D>
+        inline T div(T n) {
+            typedef reciprocal<T, D> R;
+            if constexpr (D > (T)~(T)0 >> 1) {
+                return n >= D;
+            } else if constexpr (R::POW2) {
+                return n >> R::L;
+            } else if constexpr (R::SHORT) {
+                return mulhi(n, R::M) >> R::S;
+            } else {
+                T t = mulhi(n, R::M);
+                return (t + ((n - t) >> 1)) >> (R::L - 1);
+            }
+        }
+
+        /**
+         * `(hi:lo) / d` for `hi < d`, quotient fits 16 bits
+         */
+        static inline u16 div_step(u16 hi, u16 lo, u16 d, u16 &rem) {
+            for (u8 i = 0; i < 16; i++) {
+                bool carry = hi & 0x8000;
+                hi         = (hi << 1) | (lo >> 15);
+                lo <<= 1;
+                if (carry || hi >= d) {
+                    hi -= d;
+                    lo |= 1;
+                }
+            }
+            rem = hi;
+            return lo;
+        }
+
+        /** Gain-compensated start of CORDIC rotation, 1/1.6468 of 32767 */
+        static constexpr i16 K = 19895;
+
+        static constexpr u8 ITER = 15;
+
+        /** `atan(2^-i)` as binary angle */
+        static constexpr i16 ATAN[ITER] = {8192, 4836, 2555, 1297, 651,
+                                           326,  163,  81,   41,   20,
+                                           10,   5,    3,    1,    1};
+
+        template <u8 i>
+        inline void rotate(i16 &x, i16 &y, i16 &z) {
+            i16 dx = x >> i;
+            i16 dy = y >> i;
+            if (z >= 0) {
+                x -= dy;
+                y += dx;
+                z -= ATAN[i];
+            } else {
+                x += dy;
+                y -= dx;
+                z += ATAN[i];
+            }
+            if constexpr (i + 1 < ITER)
+                rotate<i + 1>(x, y, z);
+        }
+
+        template <u8 i>
+        inline void vector(i16 &x, i16 &y, u16 &z) {
+            i16 dx = x >> i;
+            i16 dy = y >> i;
+            if (y > 0) {
+                x += dy;
+                y -= dx;
+                z += ATAN[i];
+            } else {
+                x -= dy;
+                y += dx;
+                z -= ATAN[i];
+            }
+            if constexpr (i + 1 < ITER)
+                vector<i + 1>(x, y, z);
+        }
+    }  // namespace Detail
+
+    /**
+     * Four digits of `g < 10000`, leading zeros included, from an 8.24
+     * fraction of `g / 1000`
+     */
+    static inline void digits4(u16 g, char *out) {
+        u32 f  = Driver::MPY32::mul(g, 16778);  // ceil(2^24 / 1000)
+        out[0] = '0' + (u8)(f >> 24);
+        for (u8 i = 1; i < 4; i++) {
+            f &= 0xFFFFFFul;
+            f = (f << 3) + (f << 1);
+            out[i] = '0' + (u8)(f >> 24);
+        }
+    }
+
+    /**
+     * Quotient by a compile-time constant
+     * @tparam D divisor
+     */
+    template <u32 D>
+    inline u16 div(u16 n) {
+        return Detail::div<u16, D>(n);
+    }
+
+    template <u32 D>
+    inline u32 div(u32 n) {
+        return Detail::div<u32, D>(n);
+    }
+
+    /**
+     * Remainder by a compile-time constant
+     * @tparam D divisor
+     */
+    template <u32 D>
+    inline u16 mod(u16 n) {
+        return n - div<D>(n) * (u16)D;
+    }
+
+    template <u32 D>
+    inline u32 mod(u32 n) {
+        return n - div<D>(n) * D;
+    }
+
+    /**
+     * 32/16 division: two 16-bit shift-subtract passes, the first skipped
+     * when the upper half is below the divisor
+     * @param n dividend
+     * @param d divisor, not 0
+     * @param rem receives remainder
+     * @return quotient
+     */
+    inline u32 div32(u32 n, u16 d, u16 &rem) {
+        u16 r  = (u16)(n >> 16);
+        u16 hi = 0;
+        if (r >= d)
+            hi = Detail::div_step(0, r, d, r);
+        u16 lo = Detail::div_step(r, (u16)n, d, rem);
+        return ((u32)hi << 16) | lo;
+    }
+
+    /**
+     * Integer square root, bit by bit
+     * @return `floor(sqrt(v))`
+     */
+    inline u16 isqrt(u32 v) {
+        u32 r   = 0;
+        u32 bit = 1ul << 30;
+        while (bit > v)
+            bit >>= 2;
+        while (bit) {
+            if (v >= r + bit) {
+                v -= r + bit;
+                r = (r >> 1) + bit;
+            } else {
+                r >>= 1;
+            }
+            bit >>= 2;
+        }
+        return (u16)r;
+    }
+
+    /**
+     * Sine and cosine, CORDIC rotation unrolled to constant shifts.
+     * Within 12 LSB of the exact Q15 values.
+     * @param angle binary angle, 32768 is pi
+     * @param s receives sine, Q15
+     * @param c receives cosine, Q15
+     */
+    inline void sincos(i16 angle, i16 &s, i16 &c) {
+        // Fold into -pi/2..pi/2, where CORDIC converges
+        bool flip = angle > 16384 || angle < -16384;
+        i16  z    = flip ? (i16)((u16)angle + 0x8000u) : angle;
+        i16  x    = Detail::K;
+        i16  y    = 0;
+        Detail::rotate<0>(x, y, z);
+        s = flip ? -y : y;
+        c = flip ? -x : x;
+    }
+
+    /**
+     * Angle of a vector, CORDIC vectoring unrolled to constant shifts.
+     * Input is normalized to 13 bits first. Within 14 units (0.08 degree).
+     * @return binary angle, 32768 is pi; 0 for the zero vector
+     */
+    inline i16 atan2(i16 y, i16 x) {
+        u16 m = (x < 0 ? -(u16)x : x) | (y < 0 ? -(u16)y : y);
+        if (!m)
+            return 0;
+        for (; m >= 8192; m >>= 1) {
+            x >>= 1;
+            y >>= 1;
+        }
+        for (; m < 4096; m <<= 1) {
+            x <<= 1;
+            y <<= 1;
+        }
+        u16 z = 0;
+        if (x < 0) {
+            x = -x;
+            y = -y;
+            z = 0x8000;
+        }
+        Detail::vector<0>(x, y, z);
+        return (i16)z;
+    }
+
+    /**
+     * Decimal form: groups of four digits split off with `div<10000>()`,
+     * digits of a group taken from a fixed-point fraction times 10
+     * @param v value
+     * @param out buffer of at least 11 chars
+     * @return number of digits, `out` is zero-terminated
+     */
+    inline u8 utoa(u32 v, char *out) {
+        char d[12];
+        u32  q  = div<10000>(v);
+        u16  hi = (u16)div<10000>(q);
+        digits4((u16)(v - q * 10000), d + 8);
+        digits4((u16)(q - (u32)hi * 10000), d + 4);
+        digits4(hi, d);
+        u8 first = 0;
+        while (first < 11 && d[first] == '0')
+            first++;
+        u8 n = 12 - first;
+        for (u8 i = 0; i < n; i++)
+            out[i] = d[first + i];
+        out[n] = 0;
+        return n;
+    }
+
+    /**
+     * Signed decimal form
+     * @param v value
+     * @param out buffer of at least 12 chars
+     * @return number of chars, `out` is zero-terminated
+     */
+    inline u8 itoa(i32 v, char *out) {
+        if (v >= 0)
+            return utoa((u32)v, out);
+        *out = '-';
+        return utoa(-(u32)v, out + 1) + 1;
+    }
+}  // namespace MSP430::Math
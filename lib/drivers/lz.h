@@ -0,0 +1,147 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "far.h"
+
+/**
+ * Compressed constant assets. `tools/assetpack.py` packs files at build
+ * time into an assembly source for `.persistent.high` (FRAM_HI) and a
+ * header declaring them:
+ *
+ *     #include "assets.h"
+ *
+ *     LZ::decoder<Assets::WINDOW_BITS> lz;
+ *     i16 block[64] DATA_LEA;
+ *
+ *     lz.open(asset_wave);
+ *     while (u16 n = lz.read((u8 *)block, sizeof(block)))
+ *         process(block, n);
+ *
+ * The format is LZSS: a flag byte, LSB first, tells for each of the next
+ * eight items whether it is a literal byte (1) or a match (0). A match is
+ * a little-endian word, the low `WBITS` bits are distance - 1, the high
+ * bits length - `MIN_MATCH`. Distances never exceed the window, so the
+ * decoder needs only the last `2^WBITS` output bytes, kept in a ring.
+ *
+ * `read()` stops anywhere, also inside a match, so output goes in chunks
+ * of any size to any buffer: LEA RAM, a DMA source, a pattern generator's
+ * `back()`. The packed stream is read through `Far`, so assets may lie
+ * anywhere in FRAM_HI. `src/LzBench.cpp` measures throughput.
+ */
+namespace MSP430::LZ {
+    static constexpr u16 MAGIC     = 0x5A4C;  //!< "LZ"
+    static constexpr u8  MIN_MATCH = 3;
+
+    /**
+     * Asset header, followed by the packed stream
+     */
+    struct header {
+        u16 magic;
+        u8  wbits;  //!< window bits the asset was packed for
+        u8  reserved;
+        u32 size;  //!< bytes after decoding
+    };
+
+    /**
+     * Streaming decoder
+     * @tparam WBITS window bits, 8..12, as given to `assetpack.py`. The
+     * window takes `2^WBITS` bytes of RAM.
+     */
+    template <u8 WBITS>
+    struct decoder {
+        static_assert(WBITS >= 8 && WBITS <= 12, "window of 256..4096 bytes");
+        static constexpr u16 WINDOW = 1u << WBITS;
+        static constexpr u16 MASK   = WINDOW - 1;
+
+        u8                    window[WINDOW];
+        Far::far_iterator<u8> in;
+        u32                   left;   //!< bytes still to decode
+        u16                   pos;    //!< next window slot to write
+        u16                   from;   //!< window slot of pending match
+        u16                   copy;   //!< bytes of pending match
+        u8                    flags;  //!< remaining flags of current group
+        u8                    bits;   //!< number of remaining flags
+
+        /**
+         * Start decoding an asset
+         * @param asset symbol from the generated header
+         * @return false if not an asset or packed for another window
+         */
+        bool open(const u8 *asset) {
+            const header *h = (const header *)asset;
+            left            = 0;
+            if (Far::read(&h->magic) != MAGIC || Far::read(&h->wbits) != WBITS)
+                return false;
+            left = Far::read(&h->size);
+            in.p = asset + sizeof(header);
+            pos = copy = 0;
+            bits       = 0;
+            return true;
+        }
+
+        /**
+         * Bytes still to decode
+         */
+        inline u32 remaining() const { return left; }
+
+        /**
+         * Decode next chunk
+         * @param out buffer
+         * @param n buffer size
+         * @return bytes written, less than `n` only at the end, 0 after it
+         */
+        u16 read(u8 *out, u16 n) {
+            if (n > left)
+                n = (u16)left;
+            u8 *end = out + n;
+            while (out != end) {
+                if (copy) {
+                    u16 k = end - out;
+                    if (k > copy)
+                        k = copy;
+                    copy -= k;
+                    u16 f = from;
+                    u16 p = pos;
+                    while (k--) {
+                        u8 c      = window[f];
+                        f         = (f + 1) & MASK;
+                        window[p] = c;
+                        p         = (p + 1) & MASK;
+                        *out++    = c;
+                    }
+                    from = f;
+                    pos  = p;
+                    continue;
+                }
+                if (!bits) {
+                    flags = in.next();
+                    bits  = 8;
+                }
+                bits--;
+                bool literal = flags & 1;
+                flags >>= 1;
+                if (literal) {
+                    u8 c        = in.next();
+                    window[pos] = c;
+                    pos         = (pos + 1) & MASK;
+                    *out++      = c;
+                } else {
+                    u16 t = in.next();
+                    t |= (u16)in.next() << 8;
+                    from = (pos - (t & MASK) - 1) & MASK;
+                    copy = (t >> WBITS) + MIN_MATCH;
+                }
+            }
+            left -= n;
+            return n;
+        }
+    };
+}  // namespace MSP430::LZ
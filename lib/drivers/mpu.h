@@ -0,0 +1,184 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Driver::MPU {
+    using MSP430::Tools::IOREG;
+
+    extern "C" {
+        extern char __mpu_border1[];      //!< start of constants
+        extern char __mpu_border2[];      //!< start of persistent data
+        extern char __text_high_start[];  //!< `CODE_HIGH` functions
+        extern char __text_high_end[];
+    }
+
+    /**
+     * Access rights of a segment
+     */
+    enum ACCESS : u8 {
+        R = 1 << 0,  //!< Read
+        W = 1 << 1,  //!< Write
+        X = 1 << 2,  //!< Execute
+    };
+
+    /**
+     * Main memory segments, as laid out by the linker script
+     */
+    enum class SEGMENT : u8 {
+        CODE       = 0,  //!< Segment 1: `.Reset`, `.text`
+        CONSTANT   = 1,  //!< Segment 2: `.rodata`
+        PERSISTENT = 2,  //!< Segment 3: `.persistent.*`, vectors, FRAM_HI
+        INFO       = 3,  //!< Information memory
+    };
+
+    /**
+     * Memory Protection Unit, splitting FRAM into segments with borders
+     * taken from the linker script:
+     *   - `CODE`: execute only,
+     *   - `CONSTANT`: read only,
+     *   - `PERSISTENT`: read/write, so persistent variables stay plain
+     *     stores. Also holds the vector table and all of FRAM_HI; execute
+     *     right is added only when the image has `CODE_HIGH` functions.
+     *
+     * A violating access is not performed and raises System NMI (unless
+     * configured to reset). The NMI vector must forward to `isr()`:
+     *
+     *     IRQ_HANDLER(System_NMI) { violations |= mpu.isr(); }
+     *
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct mpu {
+        enum CTL0e : u16 {
+            ENA   = 1 << 0,  //!< MPU enabled
+            LOCK  = 1 << 1,  //!< Configuration locked until BOR
+            SEGIE = 1 << 4,  //!< NMI on violation
+        };
+
+        enum CTL1e : u16 {
+            SEG1IFG  = 1 << 0,  //!< Violation in segment 1
+            SEG2IFG  = 1 << 1,  //!< Violation in segment 2
+            SEG3IFG  = 1 << 2,  //!< Violation in segment 3
+            SEGIIFG  = 1 << 3,  //!< Violation in information memory
+            SEGIPIFG = 1 << 4,  //!< Violation in IP encapsulated segment
+            IFG_M    = 0x1F,
+        };
+
+        IOREG<u16, addr + 0x00> CTL0;
+        IOREG<u8, addr + 0x01>  CTL0_H;
+        IOREG<u16, addr + 0x02> CTL1;
+        IOREG<u16, addr + 0x04> SEGB2;
+        IOREG<u16, addr + 0x06> SEGB1;
+        IOREG<u16, addr + 0x08> SAM;
+
+        /**
+         * Configure segments from linker symbols and enable the MPU
+         * @param reset_on_violation PUC instead of NMI on violation
+         */
+        void start(bool reset_on_violation = false) {
+            u8 persistent = R | W;
+            if ((__UINTPTR_TYPE__)__text_high_end
+                != (__UINTPTR_TYPE__)__text_high_start)
+                persistent |= X;
+            u16 vs = reset_on_violation ? 0b1000100010001000 : 0;
+
+            CTL0_H = 0xA5;
+            SEGB1  = (u16)((__UINTPTR_TYPE__)__mpu_border1 >> 4);
+            SEGB2  = (u16)((__UINTPTR_TYPE__)__mpu_border2 >> 4);
+            SAM    = vs | sam(SEGMENT::CODE, X) | sam(SEGMENT::CONSTANT, R)
+                   | sam(SEGMENT::PERSISTENT, persistent)
+                   | sam(SEGMENT::INFO, R | W);
+            CTL1   = 0;
+            CTL0   = 0xA500 | ENA | SEGIE;
+            CTL0_H = 0;
+        }
+
+        /**
+         * Lock configuration until next BOR. `writable` scopes cannot be
+         * used afterwards.
+         */
+        inline void lock() {
+            CTL0_H = 0xA5;
+            CTL0 |= LOCK;
+            CTL0_H = 0;
+        }
+
+        /**
+         * Current rights of a segment
+         * @param s segment
+         * @return `ACCESS` bits
+         */
+        inline u8 rights(SEGMENT s) {
+            return (SAM.get() >> (4 * (u8)s)) & (R | W | X);
+        }
+
+        /**
+         * Change rights of a segment
+         * @param s segment
+         * @param a `ACCESS` bits
+         */
+        inline void set_rights(SEGMENT s, u8 a) {
+            u16 v  = SAM.get() & ~sam(s, R | W | X);
+            CTL0_H = 0xA5;
+            SAM    = v | sam(s, a);
+            CTL0_H = 0;
+        }
+
+        /**
+         * Interrupt handler body: clears violation flags
+         * @return `CTL1e` flags of violated segments
+         */
+        inline u16 isr() {
+            u16 f  = CTL1.get() & IFG_M;
+            CTL0_H = 0xA5;
+            CTL1 &= ~f;
+            CTL0_H = 0;
+            return f;
+        }
+
+        /**
+         * Scope that grants write access to a segment, restoring previous
+         * rights when it ends:
+         *
+         *     {
+         *         auto w = mpu.writable(SEGMENT::CONSTANT);
+         *         ... update calibration constants ...
+         *     }
+         */
+        struct writable_scope {
+            SEGMENT s;
+            u8      saved;
+
+            inline writable_scope(SEGMENT seg) : s(seg) {
+                mpu m;
+                saved = m.rights(s);
+                m.set_rights(s, saved | W);
+            }
+
+            inline ~writable_scope() {
+                mpu m;
+                m.set_rights(s, saved);
+            }
+        };
+
+        /**
+         * Open a segment for writing until the end of scope
+         * @param s segment
+         * @return scope object
+         */
+        inline writable_scope writable(SEGMENT s) { return writable_scope(s); }
+
+      private:
+        static constexpr u16 sam(SEGMENT s, u8 a) {
+            return (u16)a << (4 * (u8)s);
+        }
+    };
+}  // namespace MSP430::Driver::MPU
@@ -0,0 +1,169 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Driver::MPY32 {
+    using MSP430::Tools::IOREG;
+
+    /**
+     * 32-bit hardware multiplier.
+     *
+     * Operation starts when the second operand is written, its result is
+     * ready for the next instruction. The unit is shared with compiler
+     * generated multiplications, so sequences of these calls must not be
+     * interrupted by handlers that multiply.
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct mpy32 {
+        enum CTL0e : u16 {
+            C        = 1 << 0,  //!< Carry of the multiplier
+            FRAC     = 1 << 2,  //!< Fractional (Q15) mode
+            SAT      = 1 << 3,  //!< Saturation mode
+            OP1_32   = 1 << 6,  //!< First operand is 32 bits
+            OP2_32   = 1 << 7,  //!< Second operand is 32 bits
+            DLYWRTEN = 1 << 8,  //!< Delay write to result until done
+            DLY32    = 1 << 9,  //!< Delayed write after 32-bit operation
+        };
+
+        IOREG<u16, addr + 0x00> MPY;     //!< Unsigned multiply
+        IOREG<u16, addr + 0x02> MPYS;    //!< Signed multiply
+        IOREG<u16, addr + 0x04> MAC;     //!< Unsigned multiply-accumulate
+        IOREG<u16, addr + 0x06> MACS;    //!< Signed multiply-accumulate
+        IOREG<u16, addr + 0x08> OP2;     //!< Second operand, starts operation
+        IOREG<u16, addr + 0x0A> RESLO;   //!< 16x16 result, low word
+        IOREG<u16, addr + 0x0C> RESHI;   //!< 16x16 result, high word
+        IOREG<u16, addr + 0x0E> SUMEXT;  //!< Sign/carry extension of result
+        IOREG<u16, addr + 0x10> MPY32L;
+        IOREG<u16, addr + 0x12> MPY32H;
+        IOREG<u16, addr + 0x14> MPYS32L;
+        IOREG<u16, addr + 0x16> MPYS32H;
+        IOREG<u16, addr + 0x18> MAC32L;
+        IOREG<u16, addr + 0x1A> MAC32H;
+        IOREG<u16, addr + 0x1C> MACS32L;
+        IOREG<u16, addr + 0x1E> MACS32H;
+        IOREG<u16, addr + 0x20> OP2L;
+        IOREG<u16, addr + 0x22> OP2H;  //!< Starts 32-bit operation
+        IOREG<u16, addr + 0x24> RES0;
+        IOREG<u16, addr + 0x26> RES1;
+        IOREG<u16, addr + 0x28> RES2;
+        IOREG<u16, addr + 0x2A> RES3;
+        IOREG<u16, addr + 0x2C> CTL0;
+
+        /**
+         * Unsigned 16x16 multiplication
+         * @return 32-bit product
+         */
+        inline u32 mul(u16 a, u16 b) {
+            MPY = a;
+            OP2 = b;
+            return ((u32)RESHI.get() << 16) | RESLO.get();
+        }
+
+        /**
+         * Upper half of unsigned 16x16 multiplication
+         */
+        inline u16 mulhi(u16 a, u16 b) {
+            MPY = a;
+            OP2 = b;
+            return RESHI.get();
+        }
+
+        /**
+         * Upper half of unsigned 32x32 multiplication. The upper result
+         * words are ready 7 cycles after the operand write.
+         */
+        inline u32 mulhi(u32 a, u32 b) {
+            MPY32L = (u16)a;
+            MPY32H = (u16)(a >> 16);
+            OP2L   = (u16)b;
+            OP2H   = (u16)(b >> 16);
+            __asm__ volatile("nop\n\tnop\n\tnop\n\tnop");
+            return ((u32)RES3.get() << 16) | RES2.get();
+        }
+
+        /**
+         * Signed 16x16 multiplication
+         * @return 32-bit product
+         */
+        inline i32 muls(i16 a, i16 b) {
+            MPYS = (u16)a;
+            OP2  = (u16)b;
+            return result();
+        }
+
+        /**
+         * Start signed multiply-accumulate chain with a first product
+         */
+        inline void macs_first(i16 a, i16 b) {
+            MPYS = (u16)a;
+            OP2  = (u16)b;
+        }
+
+        /**
+         * Add next signed product to the accumulator
+         */
+        inline void macs(i16 a, i16 b) {
+            MACS = (u16)a;
+            OP2  = (u16)b;
+        }
+
+        /**
+         * Accumulated 32-bit result
+         */
+        inline i32 result() {
+            return (i32)(((u32)RESHI.get() << 16) | RESLO.get());
+        }
+
+        /**
+         * Signed dot product of two Q15 vectors
+         * @param a first vector
+         * @param b second vector
+         * @param n length, at least 1
+         * @return 32-bit sum of products (wraps on overflow)
+         */
+        i32 dot(const i16 *a, const i16 *b, u16 n) {
+            macs_first(*a++, *b++);
+            while (--n)
+                macs(*a++, *b++);
+            return result();
+        }
+    };
+
+    /**
+     * Unsigned 16x16 multiplication on the device multiplier, with
+     * interrupts off while it holds operands, so handlers may multiply
+     * @return 32-bit product
+     */
+    static inline u32 mul(u16 a, u16 b) {
+        mpy32<0x4C0> hw;
+        atomic       g;
+        return hw.mul(a, b);
+    }
+
+    /**
+     * Upper half of unsigned 16x16 multiplication, see `mul()`
+     */
+    static inline u16 mulhi(u16 a, u16 b) {
+        mpy32<0x4C0> hw;
+        atomic       g;
+        return hw.mulhi(a, b);
+    }
+
+    /**
+     * Upper half of unsigned 32x32 multiplication, see `mul()`
+     */
+    static inline u32 mulhi(u32 a, u32 b) {
+        mpy32<0x4C0> hw;
+        atomic       g;
+        return hw.mulhi(a, b);
+    }
+}  // namespace MSP430::Driver::MPY32
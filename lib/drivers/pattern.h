@@ -0,0 +1,270 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "dma.h"
+#include "timer.h"
+
+namespace MSP430::Driver::Pattern {
+    using MSP430::Driver::DMA::TRANSFER;
+    using MSP430::Driver::DMA::TRIGGER;
+
+    /**
+     * Port pattern generator: DMA copies one value per timer period from a
+     * buffer (SRAM or FRAM) to `PxOUT`, or to a port pair's 16-bit output.
+     * The timer runs in up mode, its `CCR0` flag triggers each transfer, so
+     * output timing is exact and independent of the CPU. Every pin of the
+     * port is written, pins not used by the pattern must be reserved or
+     * carried in the values.
+     *
+     * Two ways of use:
+     *   - `play()` sends one buffer once, e.g. a WS2812 frame, while the
+     *     CPU sleeps; `busy()` tells when done,
+     *   - `stream()` loops over two buffers of `N` values, the application
+     *     refills `back()` and `commit()`s it while the other one is being
+     *     sent. A buffer not committed in time is sent again.
+     *
+     * Both notify through the DMA vector, which must forward to `isr()`:
+     *
+     *     IRQ_HANDLER(DMA) {
+     *         if (dma.IV.get() == 2 * (0 + 1))  // channel 0
+     *             strip.isr(dma.ch<0>());
+     *     }
+     *
+     * @tparam timerAddr base address of timer (TA0..TA4, TB0)
+     * @tparam ccrCount capture register count for this specific timer
+     * @tparam portAddr address of port (e.g. `0x220` for P3) or port pair
+     * @tparam reg `u8` for a port, `u16` for a port pair
+     * @tparam N streaming buffer length
+     */
+    template <u16 timerAddr, u8 ccrCount, u16 portAddr, typename reg = u8,
+              u16 N = 32>
+    struct generator {
+        typedef Timer::TA<timerAddr, ccrCount> TA;
+
+        reg           buffer[2][N];
+        u8            playing;    //!< streaming buffer being sent
+        volatile bool pending;    //!< `back()` committed
+        volatile bool streaming;  //!< `stream()` (not `play()`) running
+        u16           underruns;  //!< buffers sent again
+
+        /**
+         * Start timer
+         * @param period timer counts per output value
+         * @param clock `TA::CLK_*` | `TA::DIV_*`
+         */
+        void start(u16 period, u16 clock = TA::CLK_SM | TA::DIV_1) {
+            TA t;
+            t.template ccr<0>() = period - 1;
+            t.start(clock | TA::UP);
+        }
+
+        /**
+         * Stop timer and DMA
+         */
+        template <typename Channel>
+        void stop(Channel ch) {
+            TA t;
+            ch.disable();
+            t.stop();
+            streaming = false;
+        }
+
+        /**
+         * Send a buffer once
+         * @param ch DMA channel (from `dma.ch<n>()`)
+         * @param data values, anywhere in memory
+         * @param n number of values
+         */
+        template <typename Channel>
+        void play(Channel ch, const reg *data, u16 n) {
+            streaming = false;
+            ch.setup(data, out(), n, TRANSFER::SINGLE,
+                     Channel::SRC_INC | Channel::IE | width<Channel>(),
+                     trigger());
+            arm(ch);
+        }
+
+        /**
+         * Transfer of `play()` still running
+         */
+        template <typename Channel>
+        inline bool busy(Channel ch) {
+            return ch.CTL || Channel::EN;
+        }
+
+        /**
+         * Send the two buffers in turns, until `stop()`. Fill both before.
+         * @param ch DMA channel (from `dma.ch<n>()`)
+         */
+        template <typename Channel>
+        void stream(Channel ch) {
+            playing   = 0;
+            pending   = true;
+            underruns = 0;
+            streaming = true;
+            ch.setup(buffer[0], out(), N, TRANSFER::REPEATED_SINGLE,
+                     Channel::SRC_INC | Channel::IE | width<Channel>(),
+                     trigger());
+            arm(ch);
+            ch.SA = buffer[1];
+        }
+
+        /**
+         * Buffer free for refill while streaming
+         * @return `N` values, or null if already committed
+         */
+        inline reg *back() { return pending ? nullptr : buffer[playing ^ 1]; }
+
+        /**
+         * Hand refilled `back()` over for sending
+         */
+        inline void commit() { pending = true; }
+
+        /**
+         * DMA interrupt handler body for the channel in use
+         */
+        template <typename Channel>
+        inline void isr(Channel ch) {
+            if (!streaming)
+                return;
+            // DMA has reloaded from the other buffer and sends it now
+            playing ^= 1;
+            if (!pending)
+                underruns++;
+            pending = false;
+            ch.SA   = buffer[playing ^ 1];
+        }
+
+      private:
+        /**
+         * Enable DMA with the trigger flag cleared. The flag stays set
+         * while no transfer takes it, and DMA reacts only to its rising
+         * edge, so without this the first transfer would never come.
+         */
+        template <typename Channel>
+        static inline void arm(Channel ch) {
+            TA t;
+            t.template cctl<0>() &= ~TA::CCIFG;
+            ch.enable();
+        }
+
+        static inline volatile void *out() {
+            return (volatile void *)(portAddr + 0x02);
+        }
+
+        template <typename Channel>
+        static constexpr u16 width() {
+            return sizeof(reg) == 1 ? Channel::SRCBYTE | Channel::DSTBYTE : 0;
+        }
+
+        static constexpr TRIGGER trigger() {
+            static_assert(timerAddr == 0x340 || timerAddr == 0x380
+                              || timerAddr == 0x400 || timerAddr == 0x440
+                              || timerAddr == 0x7C0 || timerAddr == 0x3C0,
+                          "no CCR0 DMA trigger for this timer");
+            switch (timerAddr) {
+                case 0x340: return TRIGGER::TA0CCR0;
+                case 0x380: return TRIGGER::TA1CCR0;
+                case 0x400: return TRIGGER::TA2CCR0;
+                case 0x440: return TRIGGER::TA3CCR0;
+                case 0x7C0: return TRIGGER::TA4CCR0;
+                default: return TRIGGER::TB0CCR0;
+            }
+        }
+    };
+
+    /**
+     * WS2812 (NeoPixel) bit expansion. Each data bit becomes three output
+     * slots: `1 0 0` for zero, `1 1 0` for one. At 16 MHz with a period of
+     * 7 counts a slot is 438 ns, giving T0H = 438 ns, T1H = 875 ns and a
+     * 1.31 us bit, within WS2812 tolerances. Up to 8 strips (16 on a port
+     * pair) are driven in parallel, one per pin.
+     *
+     * A frame ends low, with no latch slots in the buffer: strips latch
+     * after `RESET_US` idle, so the next frame must not start earlier
+     * than that after `busy()` turned false.
+     * @tparam reg port value type
+     */
+    template <typename reg = u8>
+    struct ws2812 {
+        static constexpr u16 SLOTS_PER_BYTE = 24;
+        /** Idle low time that latches a frame (newer parts need 280 us) */
+        static constexpr u16 RESET_US = 280;
+
+        /**
+         * Output values needed for a frame
+         * @param bytes data bytes per strip (3 per LED)
+         */
+        static constexpr u16 size(u16 bytes) {
+            return bytes * SLOTS_PER_BYTE;
+        }
+
+        /**
+         * Clear output buffer, needed before merging several strips
+         */
+        static void clear(reg *out, u16 bytes) {
+            for (u16 i = 0; i < size(bytes); i++)
+                out[i] = 0;
+        }
+
+        /**
+         * Expand bytes of one strip, MSB first, into its pin of `out`.
+         * Other pins are kept, so strips can be merged one by one.
+         * @param data G, R, B bytes of consecutive LEDs
+         * @param bytes number of bytes
+         * @param out buffer of `size(bytes)` values
+         * @param pin pin mask of the strip
+         */
+        static void encode(const u8 *data, u16 bytes, reg *out, reg pin) {
+            for (u16 i = 0; i < bytes; i++) {
+                u8 b = data[i];
+                for (u8 k = 0; k < 8; k++, b <<= 1) {
+                    out[0] |= pin;
+                    if (b & 0x80)
+                        out[1] |= pin;
+                    else
+                        out[1] &= ~pin;
+                    out[2] &= ~pin;
+                    out += 3;
+                }
+            }
+        }
+    };
+
+    /**
+     * Stepper motor phase sequences for four consecutive pins
+     * @tparam reg port value type
+     * @tparam shift lowest of the four pins
+     */
+    template <typename reg = u8, u8 shift = 0>
+    struct stepper {
+        static_assert(shift + 4 <= 8 * sizeof(reg));
+
+        /**
+         * Fill buffer with consecutive half steps. Pins outside the four
+         * are cleared.
+         * @param out buffer
+         * @param n number of steps
+         * @param phase current phase 0..7, advanced by `n` steps
+         * @param forward direction
+         */
+        static void half_steps(reg *out, u16 n, u8 &phase, bool forward) {
+            static constexpr u8 seq[8] = {0b0001, 0b0011, 0b0010, 0b0110,
+                                          0b0100, 0b1100, 0b1000, 0b1001};
+            u8 p = phase;
+            for (u16 i = 0; i < n; i++) {
+                p      = (p + (forward ? 1 : 7)) & 7;
+                out[i] = (reg)seq[p] << shift;
+            }
+            phase = p;
+        }
+    };
+}  // namespace MSP430::Driver::Pattern
@@ -0,0 +1,312 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "gpio.h"
+
+namespace MSP430::Driver::GPIO {
+    using MSP430::Tools::IOREG;
+
+    /**
+     * Single I/O pin, described entirely at compile time
+     * @tparam Port port type, like `decltype(p1)` or `decltype(pa)`
+     * @tparam bitNo pin number in port
+     */
+    template <typename Port, u8 bitNo>
+    struct Pin {
+        typedef typename Port::reg_type reg;
+        static_assert(bitNo < 8 * sizeof(reg), "Pin falls of port");
+
+        /** Address of port pair block the pin belongs to */
+        static constexpr u16 pair = Port::base & ~1u;
+
+        /** Pin mask within 16-bit port pair word */
+        static constexpr u16 mask = (u16)((1u << bitNo)
+                                          << (8u * (Port::base & 1u)));
+
+        static inline void set() { out() |= (reg)(1u << bitNo); }
+        static inline void clear() { out() &= (reg) ~(1u << bitNo); }
+        static inline void toggle() { out() ^= (reg)(1u << bitNo); }
+
+        static inline bool read() {
+            IOREG<reg, Port::base + 0x00> in;
+            return in || (reg)(1u << bitNo);
+        }
+
+        static inline void configure(MODE m, FUNCTION f = FUNCTION::GPIO) {
+            port_simple<Port::base, reg> p;
+            p.set_function(f, (reg)(1u << bitNo));
+            p.set_mode(m, (reg)(1u << bitNo));
+        }
+
+      private:
+        static inline IOREG<reg, Port::base + 0x02> out() { return {}; }
+    };
+
+    namespace Detail {
+        template <u8... I>
+        struct seq {};
+
+        template <u8 N>
+        using make_seq = seq<__integer_pack(N)...>;
+
+        /** All pins of a group that live in one port pair */
+        struct entry {
+            u16 pair;  //!< address of port pair block
+            u16 mask;  //!< pins within pair word
+        };
+
+        template <u8 N>
+        struct entries {
+            entry e[N];
+            u8    count;
+            bool  duplicate;
+        };
+
+        /** Run of group value bits that move to port bits by one shift */
+        struct run {
+            u16 src;    //!< mask of value bits
+            i8  shift;  //!< left shift from value bit to port bit
+        };
+
+        template <u8 N>
+        struct runs {
+            run r[N];
+            u8  count;
+        };
+
+        constexpr u8 bit_of(u16 mask) {
+            u8 b = 0;
+            while ((mask >> b) != 1)
+                b++;
+            return b;
+        }
+
+        /**
+         * Merge pins into one entry per port pair, sorted by address
+         */
+        template <u8 N>
+        constexpr entries<N> collect(const u16 (&pairs)[N],
+                                     const u16 (&masks)[N]) {
+            entries<N> t{};
+            for (u8 i = 0; i < N; i++) {
+                u8 j = 0;
+                while (j < t.count && t.e[j].pair != pairs[i])
+                    j++;
+                if (j == t.count)
+                    t.e[t.count++] = {pairs[i], 0};
+                if (t.e[j].mask & masks[i])
+                    t.duplicate = true;
+                t.e[j].mask |= masks[i];
+            }
+            for (u8 i = 1; i < t.count; i++) {
+                for (u8 j = i; j > 0 && t.e[j - 1].pair > t.e[j].pair; j--) {
+                    entry tmp  = t.e[j];
+                    t.e[j]     = t.e[j - 1];
+                    t.e[j - 1] = tmp;
+                }
+            }
+            return t;
+        }
+
+        /**
+         * Shift/mask sequence that moves group value bits into port bits
+         * @param first lowest port bit of the access (0 or 8)
+         */
+        template <u8 N>
+        constexpr runs<N> spread(const u16 (&pairs)[N], const u16 (&masks)[N],
+                                 u16 pair, u8 first) {
+            runs<N> t{};
+            for (u8 i = 0; i < N; i++) {
+                if (pairs[i] != pair)
+                    continue;
+                i8 shift = (i8)(bit_of(masks[i]) - first) - (i8)i;
+                u8 j     = 0;
+                while (j < t.count && t.r[j].shift != shift)
+                    j++;
+                if (j == t.count)
+                    t.r[t.count++] = {0, shift};
+                t.r[j].src |= 1u << i;
+            }
+            return t;
+        }
+    }  // namespace Detail
+
+    /**
+     * Group of pins, possibly scattered over several ports. Pins are merged
+     * per port at compile time, so each operation touches each involved
+     * register exactly once: by word access when both halves of a port pair
+     * are involved, by byte access otherwise.
+     *
+     * Bit `i` of values used by `write()`/`read()` maps to `i`-th pin of the
+     * group.
+     * @tparam Pins list of `Pin<>` types
+     */
+    template <typename... Pins>
+    struct PinGroup {
+        static constexpr u8 N = sizeof...(Pins);
+        static_assert(N > 0 && N <= 16, "PinGroup takes 1..16 pins");
+
+      private:
+        static constexpr u16 pairs[N] = {Pins::pair...};
+        static constexpr u16 masks[N] = {Pins::mask...};
+        static constexpr auto table   = Detail::collect(pairs, masks);
+        static_assert(!table.duplicate, "PinGroup lists a pin twice");
+
+        static constexpr bool wide(Detail::entry e) {
+            return (e.mask & 0x00FF) && (e.mask & 0xFF00);
+        }
+
+        static constexpr u8 first(Detail::entry e) {
+            return (wide(e) || (e.mask & 0x00FF)) ? 0 : 8;
+        }
+
+        /**
+         * Apply operation to register at `offset` of `k`-th port entry,
+         * with narrowest possible access
+         */
+        template <u8 k, u16 offset, typename Op>
+        static inline void on(Op op) {
+            constexpr Detail::entry e = table.e[k];
+            if constexpr (wide(e)) {
+                IOREG<u16, e.pair + offset> r;
+                op(r, (u16)e.mask);
+            } else if constexpr (first(e) == 0) {
+                IOREG<u8, e.pair + offset> r;
+                op(r, (u8)e.mask);
+            } else {
+                IOREG<u8, e.pair + 1 + offset> r;
+                op(r, (u8)(e.mask >> 8));
+            }
+        }
+
+        template <u16 offset, typename Op, u8... k>
+        static inline void each(Op op, Detail::seq<k...>) {
+            (on<k, offset>(op), ...);
+        }
+
+        template <u16 offset, typename Op>
+        static inline void each(Op op) {
+            each<offset>(op, Detail::make_seq<table.count>{});
+        }
+
+        /**
+         * Port bits of `k`-th entry for given group value
+         */
+        template <u8 k>
+        static inline u16 scatter(u16 value) {
+            constexpr Detail::entry e = table.e[k];
+            constexpr auto r = Detail::spread(pairs, masks, e.pair, first(e));
+            u16            v = 0;
+            for (u8 i = 0; i < r.count; i++) {
+                if (r.r[i].shift >= 0)
+                    v |= (value & r.r[i].src) << r.r[i].shift;
+                else
+                    v |= (value & r.r[i].src) >> -r.r[i].shift;
+            }
+            return v;
+        }
+
+        /**
+         * Group bits of `k`-th entry for given port value
+         */
+        template <u8 k>
+        static inline u16 gather(u16 port) {
+            constexpr Detail::entry e = table.e[k];
+            constexpr auto r = Detail::spread(pairs, masks, e.pair, first(e));
+            u16            v = 0;
+            for (u8 i = 0; i < r.count; i++) {
+                if (r.r[i].shift >= 0)
+                    v |= (port >> r.r[i].shift) & r.r[i].src;
+                else
+                    v |= (port << -r.r[i].shift) & r.r[i].src;
+            }
+            return v;
+        }
+
+        template <u8 k>
+        static inline void write_one(u16 value) {
+            on<k, 0x02>([value](auto r, auto m) {
+                r.mask_set(~m, (decltype(m))scatter<k>(value));
+            });
+        }
+
+        template <u8... k>
+        static inline void write_all(u16 value, Detail::seq<k...>) {
+            (write_one<k>(value), ...);
+        }
+
+        template <u8 k>
+        static inline u16 read_one() {
+            u16 v = 0;
+            on<k, 0x00>([&v](auto r, auto) { v = gather<k>(r.get()); });
+            return v;
+        }
+
+        template <u8... k>
+        static inline u16 read_all(Detail::seq<k...>) {
+            return (read_one<k>() | ...);
+        }
+
+      public:
+        /** Number of distinct port registers touched by each operation */
+        static constexpr u8 ports = table.count;
+
+        /** Drive all pins high */
+        static inline void set() {
+            each<0x02>([](auto r, auto m) { r |= m; });
+        }
+
+        /** Drive all pins low */
+        static inline void clear() {
+            each<0x02>([](auto r, auto m) { r &= ~m; });
+        }
+
+        /** Toggle all pins */
+        static inline void toggle() {
+            each<0x02>([](auto r, auto m) { r ^= m; });
+        }
+
+        /**
+         * Drive pins with bits of value, one read-modify-write per port
+         * @param value bit `i` goes to `i`-th pin of group
+         */
+        static inline void write(u16 value) {
+            write_all(value, Detail::make_seq<table.count>{});
+        }
+
+        /**
+         * Sample pins, one read per port
+         * @return bit `i` comes from `i`-th pin of group
+         */
+        static inline u16 read() {
+            return read_all(Detail::make_seq<table.count>{});
+        }
+
+        /**
+         * Configure direction/resistors and function of all pins
+         * @param m pin mode
+         * @param f pin function
+         */
+        static inline void configure(MODE m, FUNCTION f = FUNCTION::GPIO) {
+            each<0x00>(
+                [m, f](auto r, auto mask) { configure_port(r, mask, m, f); });
+        }
+
+      private:
+        template <typename reg, u16 addr>
+        static inline void configure_port(IOREG<reg, addr>, reg mask, MODE m,
+                                          FUNCTION f) {
+            port_simple<addr, reg> p;
+            p.set_function(f, mask);
+            p.set_mode(m, mask);
+        }
+    };
+}  // namespace MSP430::Driver::GPIO
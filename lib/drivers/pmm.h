@@ -29,6 +29,78 @@ namespace MSP430::Driver::PMM {
          * I/O ports
          */
         void unlock_pm5() { PM5CTL0.template bit<0>().clear(); }
+
+        /**
+         * Check if this start is a wake-up from LPM3.5/LPM4.5, and clear
+         * the indication
+         * @return
+         */
+        bool woke_from_lpmx5() {
+            if (!(IFG || LPM5IFG))
+                return false;
+            CTL0_H = PW;
+            IFG &= ~LPM5IFG;
+            CTL0_H = 0;
+            return true;
+        }
+
+        /**
+         * Enter LPM3.5: core regulator off, only RTC_C (and LFXT) keeps
+         * running. Wake-up by RTC or port interrupt restarts the device
+         * through reset. Configure wake sources and I/O state first.
+         */
+        [[noreturn]] void enter_lpm35() {
+            regulator_off();
+            SR::set(GIE | CPUOFF | SCG0 | SCG1);
+            while (true) {
+            }
+        }
+
+        /**
+         * Enter LPM4.5: everything is off, only port interrupts wake the
+         * device up, through reset.
+         */
+        [[noreturn]] void enter_lpm45() {
+            regulator_off();
+            SR::set(GIE | CPUOFF | OSCOFF | SCG0 | SCG1);
+            while (true) {
+            }
+        }
+
+        /**
+         * Software brownout reset: restarts from the reset vector with all
+         * modules, MPU included, back in their reset state
+         */
+        [[noreturn]] void reset_bor() {
+            CTL0_H = PW;
+            CTL0_L |= SWBOR;
+            while (true) {
+            }
+        }
+
+      private:
+        enum : u16 {
+            PW      = 0xA5,      //!< PMM password (upper byte of CTL0)
+            SWBOR   = 1 << 2,    //!< Software brownout reset
+            REGOFF  = 1 << 4,    //!< Regulator off on LPM entry
+            SVSHE   = 1 << 6,    //!< High-side supervisor enable
+            LPM5IFG = 1u << 15,  //!< LPMx.5 wake-up flag
+            GIE     = 1 << 3,    //!< SR: interrupts enabled
+            CPUOFF  = 1 << 4,    //!< SR: CPU off
+            OSCOFF  = 1 << 5,    //!< SR: LFXT off
+            SCG0    = 1 << 6,    //!< SR: system clock generator 0 off
+            SCG1    = 1 << 7,    //!< SR: system clock generator 1 off
+        };
+
+        IOREG<u8, addr + 0x00> CTL0_L;
+        IOREG<u8, addr + 0x01> CTL0_H;
+
+        inline void regulator_off() {
+            CTL0_H = PW;
+            CTL0_L |= REGOFF;
+            CTL0_L &= ~SVSHE;
+            CTL0_H = 0;
+        }
     };
 
 }  // namespace MSP430::Driver::PMM
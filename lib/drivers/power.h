@@ -0,0 +1,194 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "pmm.h"
+#include "rtc.h"
+
+namespace MSP430::Power {
+    /**
+     * Idle levels, from the shallowest to the deepest
+     */
+    enum class LEVEL : u8 {
+        ACTIVE,  //!< Not sleeping, `idle()` returns at once
+        LPM0,
+        LPM1,
+        LPM2,
+        LPM3,
+        LPM4,
+        LPMX5,  //!< LPM3.5 when RTC runs, LPM4.5 otherwise; wakes via reset
+        LEVELS,
+    };
+
+    /**
+     * Deepest level allowed by current requests
+     */
+    inline LEVEL deepest() {
+        if (needs[(u8)NEED::CPU])
+            return LEVEL::ACTIVE;
+        if (needs[(u8)NEED::SMCLK])
+            return LEVEL::LPM1;
+        if (needs[(u8)NEED::ACLK])
+            return LEVEL::LPM3;
+        if (needs[(u8)NEED::RETENTION])
+            return LEVEL::LPM4;
+        return LEVEL::LPMX5;
+    }
+
+    /**
+     * Residency and wake-ups of one idle level
+     */
+    struct stat {
+        u32 entries;  //!< times entered (for `ACTIVE`: `idle()` calls)
+        u32 ticks;    //!< time spent, in time base ticks
+    };
+
+    /**
+     * Power-mode governor. Drivers take reference-counted requests for
+     * what they need (`Power::request()`) when they start and drop them
+     * when they stop, `idle()` then enters the deepest mode meeting all
+     * of them:
+     *
+     *     Power::governor<Delay::timer> power DATA_PERSISTENT;
+     *
+     *     power.start();
+     *     ta0.start(ta0.CLK_SM | ta0.UP);  // PWM from SMCLK: LPM1 at most
+     *     ...
+     *     ta0.stop();
+     *     while (true)
+     *         power.idle();  // nothing pending: LPMx.5
+     *
+     * Requests may be changed from interrupt handlers. A handler that
+     * should make `idle()` return must clear LPM bits on exit, and some
+     * such interrupt must be enabled before `idle()`.
+     *
+     * Time spent in each level is measured with `Clock`, a free-running
+     * 16-bit time base, so a single stay longer than its wrap period
+     * (2 s with ACLK at 32768 Hz) is counted modulo that period. An ACLK
+     * time base stops in LPM4, so such stays count as entries only. The
+     * whole structure may live in FRAM to keep statistics across resets.
+     *
+     * @tparam Clock time base, type with `static void start()` and
+     * `static u16 now()` that keeps counting in LPM3
+     * @tparam pmmAddr base address of PMM
+     * @tparam rtcAddr base address of RTC_C
+     */
+    template <typename Clock, u16 pmmAddr = 0x120, u16 rtcAddr = 0x4A0>
+    struct governor {
+        u16  last;  //!< time of last level change
+        stat stats[(u8)LEVEL::LEVELS];
+
+        /**
+         * Start time base. Statistics are kept.
+         */
+        void start() {
+            Clock::start();
+            last = Clock::now();
+        }
+
+        /**
+         * Drop statistics
+         */
+        void clear_stats() {
+            for (u8 i = 0; i < (u8)LEVEL::LEVELS; i++)
+                stats[i] = {};
+            last = Clock::now();
+        }
+
+        /**
+         * Add a request not tied to a driver (e.g. `NEED::CPU` while
+         * polling), see `Power::request()`
+         * @param n what is needed
+         */
+        inline void request(NEED n) { Power::request(n); }
+
+        /**
+         * Drop a request added with `request()`
+         * @param n what was needed
+         */
+        inline void release(NEED n) { Power::release(n); }
+
+        /**
+         * Deepest level allowed by current requests, see `Power::deepest()`
+         */
+        inline LEVEL deepest() { return Power::deepest(); }
+
+        /**
+         * Sleep in the deepest allowed level until an interrupt handler
+         * clears LPM bits. Returns at once if the CPU is needed. Interrupts
+         * are enabled on return.
+         * @return level that was entered
+         */
+        NOINLINE LEVEL idle() {
+            disable_interrupts();
+            LEVEL l   = Power::deepest();
+            u16   now = Clock::now();
+            account(LEVEL::ACTIVE, now);
+
+            switch (l) {
+                case LEVEL::ACTIVE: enable_interrupts(); return l;
+                case LEVEL::LPM1: set_low_power(POWER::MODE1); break;
+                case LEVEL::LPM3: set_low_power(POWER::MODE3); break;
+                case LEVEL::LPM4: set_low_power(POWER::MODE4); break;
+                default: enter_lpmx5();
+            }
+
+            account(l, Clock::now());
+            return l;
+        }
+
+        /**
+         * Share of time spent in a level since statistics were cleared
+         * @param l level
+         * @return fraction in 1/65536 units
+         */
+        u16 duty(LEVEL l) {
+            u32 total = 0;
+            for (u8 i = 0; i < (u8)LEVEL::LEVELS; i++)
+                total += stats[i].ticks;
+            u32 part = stats[(u8)l].ticks;
+            // Scale both down until the quotient needs no 32-bit division
+            while (total > 0xFFFF) {
+                total >>= 1;
+                part >>= 1;
+            }
+            if (!total)
+                return 0;
+            u16 q = 0;
+            u32 r = part;
+            for (u8 b = 0; b < 16; b++) {
+                r <<= 1;
+                q <<= 1;
+                if (r >= total) {
+                    r -= total;
+                    q |= 1;
+                }
+            }
+            return q;
+        }
+
+      private:
+        inline void account(LEVEL l, u16 now) {
+            stat &s = stats[(u8)l];
+            s.entries++;
+            s.ticks += (u16)(now - last);
+            last = now;
+        }
+
+        [[noreturn]] void enter_lpmx5() {
+            Driver::PMM::pmm<pmmAddr> p;
+            Driver::RTC::rtc<rtcAddr> r;
+            stats[(u8)LEVEL::LPMX5].entries++;
+            if (r.running())
+                p.enter_lpm35();
+            p.enter_lpm45();
+        }
+    };
+}  // namespace MSP430::Power
@@ -0,0 +1,191 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "timer.h"
+
+/**
+ * Profiling probes are compiled in only when `MSP430_PROFILE` is defined,
+ * otherwise `PROFILE_SCOPE(id)` compiles to nothing. Probes record into the
+ * global profiler named by `MSP430_PROFILER` (`profiler` by default):
+ *
+ *     MSP430::Profile::profiler<0x7C0, 2, 8> profiler DATA_PERSISTENT;
+ *
+ *     void control_loop() {
+ *         PROFILE_SCOPE(3);
+ *         ...
+ *     }
+ */
+#ifndef MSP430_PROFILER
+#define MSP430_PROFILER profiler
+#endif
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b)  PROFILE_CONCAT_(a, b)
+
+#ifdef MSP430_PROFILE
+#define PROFILE_SCOPE(id)                                                      \
+    MSP430::Profile::scope<decltype(MSP430_PROFILER), id> PROFILE_CONCAT(      \
+        profile_scope_, __LINE__)(MSP430_PROFILER)
+#else
+#define PROFILE_SCOPE(id) (void)0
+#endif
+
+namespace MSP430::Profile {
+    /** Histogram buckets: bucket `b` counts durations in `[2^(b-1), 2^b)` */
+    static constexpr u8 BUCKETS = 17;
+
+    /**
+     * Statistics of a single probe. Layout is read by `tools/profdump.py`.
+     */
+    struct probe {
+        u32 count;
+        u32 sum;
+        u16 min;
+        u16 max;
+        u16 hist[BUCKETS];  //!< saturating counters
+
+        inline void clear() {
+            count = 0;
+            sum   = 0;
+            min   = 0xFFFF;
+            max   = 0;
+            for (u8 i = 0; i < BUCKETS; i++)
+                hist[i] = 0;
+        }
+
+        inline void add(u16 cycles) {
+            count++;
+            sum += cycles;
+            if (cycles < min)
+                min = cycles;
+            if (cycles > max)
+                max = cycles;
+            u8 b = 0;
+            for (u16 c = cycles; c; c >>= 1)
+                b++;
+            if (hist[b] != 0xFFFF)
+                hist[b]++;
+        }
+    };
+
+    /**
+     * Cycle profiler: a free-running Timer_A and a table of probes.
+     *
+     * The timer runs from SMCLK undivided, Timer_A cannot be clocked from
+     * MCLK directly, so keep `SMCLK = MCLK` while profiling to get CPU
+     * cycles. Single scope must be shorter than 65536 cycles. Cost of
+     * two back-to-back timer reads is measured by `start()` and subtracted
+     * from every record.
+     *
+     * The table may live in FRAM (`DATA_PERSISTENT`, survives reset, read
+     * it later with a debugger) or in RAM (`DATA_LEA`). Its memory image is
+     * decoded by `tools/profdump.py`, the same bytes are sent by `dump()`.
+     * @tparam timerAddr base address of dedicated Timer_A
+     * @tparam ccrCount capture register count for this specific timer
+     * @tparam N number of probe ids
+     */
+    template <u16 timerAddr, u8 ccrCount, u8 N>
+    struct profiler {
+        typedef Driver::Timer::TA<timerAddr, ccrCount> TA;
+
+        static constexpr u16 MAGIC   = 0x4650;  //!< "PF"
+        static constexpr u8  VERSION = 1;
+        static constexpr u8  PROBES  = N;
+
+        u16   magic;
+        u8    version;
+        u8    probes;
+        u8    buckets;
+        u8    reserved;
+        u16   overhead;  //!< cycles subtracted from each record
+        probe table[N];
+
+        /**
+         * Clear statistics, start the timer and measure probe overhead
+         */
+        void start() {
+            TA t;
+            t.start(TA::CLK_SM | TA::DIV_1 | TA::CONT);
+
+            magic    = MAGIC;
+            version  = VERSION;
+            probes   = N;
+            buckets  = BUCKETS;
+            reserved = 0;
+            overhead = 0;
+            reset();
+
+            u16 best = 0xFFFF;
+            for (u8 i = 0; i < 8; i++) {
+                u16 t0 = now();
+                u16 d  = now() - t0;
+                if (d < best)
+                    best = d;
+            }
+            overhead = best;
+        }
+
+        /**
+         * Clear statistics of all probes
+         */
+        void reset() {
+            for (u8 i = 0; i < N; i++)
+                table[i].clear();
+        }
+
+        /**
+         * Current cycle count
+         */
+        static inline u16 now() {
+            TA t;
+            return t.R.get();
+        }
+
+        /**
+         * Add one duration to a probe. Safe to call from interrupts.
+         * @param id probe id
+         * @param start `now()` at scope entry
+         */
+        inline void record(u8 id, u16 start) {
+            u16 d  = now() - start;
+            d      = (d > overhead) ? d - overhead : 0;
+            atomic g;
+            table[id].add(d);
+        }
+
+        /**
+         * Send table image byte by byte, e.g. to a UART
+         * @param out callable taking `u8`
+         */
+        template <typename Out>
+        void dump(Out out) const {
+            const u8 *p = (const u8 *)this;
+            for (u16 i = 0; i < sizeof(*this); i++)
+                out(p[i]);
+        }
+    };
+
+    /**
+     * RAII probe, records duration of enclosing scope. Use `PROFILE_SCOPE`.
+     * @tparam Profiler profiler type
+     * @tparam id probe id
+     */
+    template <typename Profiler, u8 id>
+    struct scope {
+        static_assert(id < Profiler::PROBES, "probe id out of range");
+
+        Profiler &p;
+        u16       start;
+
+        inline scope(Profiler &prof) : p(prof), start(Profiler::now()) {}
+        inline ~scope() { p.record(id, start); }
+    };
+}  // namespace MSP430::Profile
@@ -0,0 +1,193 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "dma.h"
+#include "timer.h"
+
+namespace MSP430::Driver::PWM {
+    using MSP430::Driver::DMA::TRANSFER;
+    using MSP430::Driver::DMA::TRIGGER;
+
+    /**
+     * PWM alignment
+     */
+    enum class ALIGN {
+        EDGE,    //!< Up mode, period = `TBxCL0 + 1`
+        CENTER,  //!< Up/down mode, period = `2 * TBxCL0`, allows dead time
+    };
+
+    /**
+     * Glitch-free 6-channel PWM engine on a 7-channel Timer_B.
+     *
+     * `TBxCCR0` sets the period, `TBxCCR1..6` the duty cycles. All compare
+     * latches are grouped (`TBCLGRP_7`), so a new set of duty cycles is
+     * loaded into the hardware by one event, never channel by channel:
+     *   - edge-aligned: when the counter reaches `TBxCL0`,
+     *   - center-aligned: when the counter reaches 0.
+     *
+     * Duties can be written directly (`write()`) or by DMA triggered by
+     * `TBxCCR0` every period. In the latter case the control loop only fills
+     * `back()` buffer and calls `publish()`; the DMA transfer lands at least
+     * half a period before the latch load, so no set is ever torn.
+     *
+     * Output pins must be switched to timer function by the application.
+     * @tparam addr base address of Timer_B
+     */
+    template <u16 addr>
+    struct pwm {
+        typedef Timer::TB<addr, 7> TB;
+
+        static constexpr u8 CHANNELS = 6;
+
+        u16   buffer[2][CHANNELS];
+        u8    front;
+        ALIGN align;
+
+        /**
+         * Configure and start the timer. All channels start with zero duty.
+         * @param period counts of `TBxCCR0` (see `ALIGN`)
+         * @param a alignment
+         * @param clock `TB::CLK_*` | `TB::DIV_*`
+         */
+        void start(u16 period, ALIGN a = ALIGN::EDGE,
+                   u16 clock = TB::CLK_SM | TB::DIV_1) {
+            TB t;
+            align = a;
+            front = 0;
+            for (u8 i = 0; i < CHANNELS; i++)
+                buffer[0][i] = buffer[1][i] = 0;
+
+            t.stop();
+            t.template ccr<0>() = (a == ALIGN::EDGE) ? period - 1 : period;
+            write(buffer[0]);
+            configure_all((a == ALIGN::EDGE) ? TB::OUTMOD_RESET_SET
+                                             : TB::OUTMOD_TOGGLE_RESET);
+            t.start(TB::TBCLGRP_7 | TB::CNTL_16 | clock
+                    | ((a == ALIGN::EDGE) ? TB::UP : TB::UP_DOWN));
+        }
+
+        /**
+         * Stop the timer, outputs keep their last state
+         */
+        void stop() {
+            TB t;
+            t.stop();
+        }
+
+        /**
+         * Set output mode of single channel
+         * @tparam nr channel 1..6
+         * @param outmod one of `TB::OUTMOD_*`
+         */
+        template <u8 nr>
+        inline void output(u16 outmod) {
+            static_assert(nr >= 1 && nr <= CHANNELS);
+            TB t;
+            t.template cctl<nr>() = outmod | (nr == 1 ? load_event() : 0);
+        }
+
+        /**
+         * Configure channel pairs (1,2), (3,4), (5,6) as complementary
+         * high/low side outputs with dead time. Center-aligned mode only:
+         * odd channel is high while counter < duty, even channel while
+         * counter > duty + dead time.
+         */
+        void complementary() {
+            output<1>(TB::OUTMOD_TOGGLE_RESET);
+            output<2>(TB::OUTMOD_TOGGLE_SET);
+            output<3>(TB::OUTMOD_TOGGLE_RESET);
+            output<4>(TB::OUTMOD_TOGGLE_SET);
+            output<5>(TB::OUTMOD_TOGGLE_RESET);
+            output<6>(TB::OUTMOD_TOGGLE_SET);
+        }
+
+        /**
+         * Fill duty pair of complementary phase into a buffer
+         * @param buf buffer (from `back()` or own one)
+         * @param phase 0..2
+         * @param duty high-side duty in counts, 0..`TBxCL0`
+         * @param dead dead time in counts, inserted at both edges
+         */
+        static inline void set_phase(u16 *buf, u8 phase, u16 duty, u16 dead) {
+            TB  t;
+            u16 top = t.template ccr<0>().get();
+            if (duty > top)
+                duty = top;
+            u16 low = (top - duty > dead) ? duty + dead : top;
+            buf[2 * phase]     = duty;
+            buf[2 * phase + 1] = low;
+        }
+
+        /**
+         * Write all duties directly. They are taken by the hardware at the
+         * next load event, all at once.
+         * @param duty six duty values
+         */
+        inline void write(const u16 *duty) {
+            TB t;
+            t.template ccr<1>() = duty[0];
+            t.template ccr<2>() = duty[1];
+            t.template ccr<3>() = duty[2];
+            t.template ccr<4>() = duty[3];
+            t.template ccr<5>() = duty[4];
+            t.template ccr<6>() = duty[5];
+        }
+
+        /**
+         * Let DMA copy front buffer into `TBxCCR1..6` each period
+         * @tparam Channel DMA channel type (from `dma.ch<n>()`)
+         * @param ch DMA channel to use
+         */
+        template <typename Channel>
+        void attach_dma(Channel ch) {
+            ch.setup(buffer[front], (volatile void *)(addr + 0x14), CHANNELS,
+                     TRANSFER::REPEATED_BLOCK,
+                     Channel::SRC_INC | Channel::DST_INC, trigger());
+            ch.enable();
+        }
+
+        /**
+         * Buffer that may be freely written by the control loop
+         * @return six duty values
+         */
+        inline u16 *back() { return buffer[front ^ 1]; }
+
+        /**
+         * Make back buffer the one copied by DMA from next period on.
+         * Single 20-bit write of DMA source, so it is atomic.
+         * @param ch DMA channel given to `attach_dma()`
+         */
+        template <typename Channel>
+        inline void publish(Channel ch) {
+            front ^= 1;
+            ch.SA = buffer[front];
+        }
+
+      private:
+        inline u16 load_event() {
+            return (align == ALIGN::EDGE) ? TB::CLLD_CL0 : TB::CLLD_ZERO;
+        }
+
+        void configure_all(u16 outmod) {
+            output<1>(outmod);
+            output<2>(outmod);
+            output<3>(outmod);
+            output<4>(outmod);
+            output<5>(outmod);
+            output<6>(outmod);
+        }
+
+        static constexpr TRIGGER trigger() {
+            static_assert(addr == 0x3C0, "DMA trigger known only for TB0");
+            return TRIGGER::TB0CCR0;
+        }
+    };
+}  // namespace MSP430::Driver::PWM
@@ -0,0 +1,80 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Tools {
+    /**
+     * Lock-free single-producer single-consumer ring buffer, meant to pass
+     * data between an ISR and the main loop. One slot is kept empty, so
+     * `N - 1` elements fit.
+     * @tparam T element type
+     * @tparam N number of slots, power of 2
+     */
+    template <typename T, u16 N>
+    struct ring {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be power of 2");
+        static constexpr u16 MASK = N - 1;
+
+        T            data[N];
+        volatile u16 head;  //!< next slot to write, owned by producer
+        volatile u16 tail;  //!< next slot to read, owned by consumer
+
+        /**
+         * Drop all content. Not safe against concurrent push/pop.
+         */
+        inline void clear() {
+            head = 0;
+            tail = 0;
+        }
+
+        inline bool empty() const { return head == tail; }
+        inline bool full() const { return ((head + 1) & MASK) == tail; }
+        inline u16  size() const { return (head - tail) & MASK; }
+
+        /**
+         * Append element
+         * @param v value
+         * @return false if buffer was full and value was dropped
+         */
+        inline bool push(const T &v) {
+            u16 h    = head;
+            u16 next = (h + 1) & MASK;
+            if (next == tail)
+                return false;
+            data[h] = v;
+            head    = next;
+            return true;
+        }
+
+        /**
+         * Take oldest element
+         * @param v receives value
+         * @return false if buffer was empty
+         */
+        inline bool pop(T &v) {
+            u16 t = tail;
+            if (t == head)
+                return false;
+            v    = data[t];
+            tail = (t + 1) & MASK;
+            return true;
+        }
+
+        /**
+         * Look at oldest element without taking it
+         * @param i position from oldest one
+         * @return element
+         */
+        inline const T &peek(u16 i = 0) const {
+            return data[(tail + i) & MASK];
+        }
+    };
+}  // namespace MSP430::Tools
@@ -0,0 +1,282 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Driver::RTC {
+    using MSP430::Tools::IOREG;
+
+    enum CTL0e : u8 {
+        OFIE   = 1 << 7,  //!< 32-kHz crystal oscillator fault interrupt enable
+        TEVIE  = 1 << 6,  //!< Real-time clock time event interrupt enable
+        AIE    = 1 << 5,  //!< Real-time clock alarm interrupt enable
+        RDYIE  = 1 << 4,  //!< Real-time clock ready interrupt enable
+        OFIFG  = 1 << 3,  //!< 32-kHz crystal oscillator fault interrupt flag
+        TEVIFG = 1 << 2,  //!< Real-time clock time event interrupt flag
+        AIFG   = 1 << 1,  //!< Real-time clock alarm interrupt flag
+        RDYIFG = 1 << 0,  //!< Real-time clock ready interrupt flag
+    };
+
+    enum CTL1e : u8 {
+        BCD  = 1 << 7,  //!< Calendar registers hold BCD (otherwise binary)
+        HOLD = 1 << 6,  //!< Calendar is stopped
+        RDY  = 1 << 4,  //!< Calendar registers are safe to read
+    };
+
+    /**
+     * Calendar event that sets `TEVIFG`
+     */
+    enum class EVENT : u8 {
+        MINUTE   = 0b00,  //!< Each minute change
+        HOUR     = 0b01,  //!< Each hour change
+        MIDNIGHT = 0b10,  //!< Each day at 00:00
+        NOON     = 0b11,  //!< Each day at 12:00
+    };
+
+    /**
+     * Rate of prescaler 1 interval interrupt
+     */
+    enum class INTERVAL : u8 {
+        HZ_64  = 0b000 << 2,
+        HZ_32  = 0b001 << 2,
+        HZ_16  = 0b010 << 2,
+        HZ_8   = 0b011 << 2,
+        HZ_4   = 0b100 << 2,
+        HZ_2   = 0b101 << 2,
+        HZ_1   = 0b110 << 2,
+        HZ_0_5 = 0b111 << 2,
+    };
+
+    /**
+     * Source of RTC interrupt, as decoded from `RTCIV`
+     */
+    enum class SOURCE : u16 {
+        NONE        = 0x00,
+        OSC_FAULT   = 0x02,  //!< 32-kHz crystal fault
+        READY       = 0x04,  //!< Calendar registers ready
+        TIME_EVENT  = 0x06,  //!< `EVENT` happened
+        ALARM       = 0x08,  //!< Alarm matched
+        PRESCALER_0 = 0x0A,  //!< Prescaler 0 interval
+        PRESCALER_1 = 0x0C,  //!< Prescaler 1 interval (`INTERVAL`)
+    };
+
+    /**
+     * Calendar contents, binary or BCD depending on mode
+     */
+    struct datetime {
+        u8  sec;
+        u8  min;
+        u8  hour;
+        u8  dow;  //!< day of week, 0..6
+        u8  day;
+        u8  month;
+        u16 year;
+    };
+
+    /**
+     * State kept in FRAM across LPMx.5 and resets. FR5994 RTC_C has no
+     * battery-backed registers, and RAM is lost in LPMx.5, so declare one
+     * with `DATA_PERSISTENT`.
+     */
+    struct backup {
+        u16 magic;    //!< `MAGIC` once initialised
+        u16 wakeups;  //!< LPMx.5 wake-ups, counted by application
+        u32 user[4];  //!< free for application
+
+        static constexpr u16 MAGIC = 0x52C5;
+
+        /**
+         * Initialise on first use
+         * @return true if it was not initialised before
+         */
+        inline bool init() {
+            if (magic == MAGIC)
+                return false;
+            wakeups = 0;
+            for (u8 i = 0; i < 4; i++)
+                user[i] = 0;
+            magic = MAGIC;
+            return true;
+        }
+    };
+
+    /**
+     * RTC_C in calendar mode, clocked from 32.768 kHz LFXT.
+     *
+     * The calendar and its interrupt configuration are retained in LPM3.5,
+     * so the device may sleep there for hours with the RTC as the only wake
+     * source (see `pmm::enter_lpm35()`). After such wake-up execution starts
+     * at reset; reconfigure I/O, unlock it with `pmm::unlock_pm5()` and the
+     * pending RTC interrupt is served as soon as interrupts are enabled.
+     * @tparam addr base address of device
+     */
+    template <u16 addr>
+    struct rtc {
+        IOREG<u8, addr + 0x00>  CTL0_L;
+        IOREG<u8, addr + 0x01>  CTL0_H;
+        IOREG<u8, addr + 0x02>  CTL1;
+        IOREG<u8, addr + 0x03>  CTL3;
+        IOREG<u16, addr + 0x04> OCAL;
+        IOREG<u16, addr + 0x06> TCMP;
+        IOREG<u16, addr + 0x08> PS0CTL;
+        IOREG<u16, addr + 0x0A> PS1CTL;
+        IOREG<u16, addr + 0x0C> PS;
+        IOREG<u16, addr + 0x0E> IV;
+        IOREG<u8, addr + 0x10>  SEC;
+        IOREG<u8, addr + 0x11>  MIN;
+        IOREG<u8, addr + 0x12>  HOUR;
+        IOREG<u8, addr + 0x13>  DOW;
+        IOREG<u8, addr + 0x14>  DAY;
+        IOREG<u8, addr + 0x15>  MON;
+        IOREG<u16, addr + 0x16> YEAR;
+        IOREG<u8, addr + 0x18>  AMIN;
+        IOREG<u8, addr + 0x19>  AHOUR;
+        IOREG<u8, addr + 0x1A>  ADOW;
+        IOREG<u8, addr + 0x1B>  ADAY;
+        IOREG<u16, addr + 0x1C> BIN2BCD;
+        IOREG<u16, addr + 0x1E> BCD2BIN;
+
+        /** Alarm field value meaning "any" */
+        static constexpr u8 ANY = 0xFF;
+
+        /**
+         * Unlock RTC registers for writing (`RTCKEY`)
+         */
+        inline void unlock() { CTL0_H = 0xA5; }
+
+        /**
+         * Lock RTC registers
+         */
+        inline void lock() { CTL0_H = 0x00; }
+
+        /**
+         * Check if calendar is already running, e.g. after LPMx.5 wake-up
+         * @return
+         */
+        inline bool running() { return !(CTL1 || HOLD); }
+
+        /**
+         * Set calendar and start it
+         * @param t time and date
+         * @param bcd calendar registers hold BCD values
+         */
+        void start(const datetime &t, bool bcd = false) {
+            unlock();
+            CTL1 = HOLD | (bcd ? BCD : 0);
+            SEC  = t.sec;
+            MIN  = t.min;
+            HOUR = t.hour;
+            DOW  = t.dow;
+            DAY  = t.day;
+            MON  = t.month;
+            YEAR = t.year;
+            CTL1 &= ~HOLD;
+            lock();
+        }
+
+        /**
+         * Read consistent calendar snapshot
+         * @param t receives time and date
+         */
+        void get(datetime &t) {
+            do {
+                while (!(CTL1 || RDY)) {
+                }
+                t.sec   = SEC.get();
+                t.min   = MIN.get();
+                t.hour  = HOUR.get();
+                t.dow   = DOW.get();
+                t.day   = DAY.get();
+                t.month = MON.get();
+                t.year  = YEAR.get();
+            } while (t.sec != SEC.get());
+        }
+
+        /**
+         * Set and enable alarm. Fields set to `ANY` are not compared.
+         * @param min minute
+         * @param hour hour
+         * @param dow day of week
+         * @param day day of month
+         */
+        void alarm(u8 min, u8 hour = ANY, u8 dow = ANY, u8 day = ANY) {
+            unlock();
+            CTL0_L &= ~(AIE | AIFG);
+            AMIN  = (min == ANY) ? 0 : (0x80 | min);
+            AHOUR = (hour == ANY) ? 0 : (0x80 | hour);
+            ADOW  = (dow == ANY) ? 0 : (0x80 | dow);
+            ADAY  = (day == ANY) ? 0 : (0x80 | day);
+            CTL0_L |= AIE;
+            lock();
+        }
+
+        /**
+         * Disable alarm
+         */
+        void alarm_off() {
+            unlock();
+            CTL0_L &= ~(AIE | AIFG);
+            AMIN  = 0;
+            AHOUR = 0;
+            ADOW  = 0;
+            ADAY  = 0;
+            lock();
+        }
+
+        /**
+         * Enable calendar event interrupt
+         * @param e event
+         */
+        void event(EVENT e) {
+            unlock();
+            CTL1.template bits<0, 1>() = (u8)e;
+            CTL0_L &= ~TEVIFG;
+            CTL0_L |= TEVIE;
+            lock();
+        }
+
+        /**
+         * Enable periodic prescaler 1 interrupt
+         * @param i rate
+         */
+        void interval(INTERVAL i) { PS1CTL = (u16)i | (1u << 1); }
+
+        /**
+         * Disable periodic prescaler 1 interrupt
+         */
+        void interval_off() { PS1CTL = 0; }
+
+        /**
+         * Interrupt handler body: acknowledges highest pending source
+         * @return source served
+         */
+        inline SOURCE isr() { return (SOURCE)IV.get(); }
+
+        /**
+         * Convert binary to BCD by hardware
+         * @param v binary value, up to 9999
+         * @return BCD value
+         */
+        inline u16 to_bcd(u16 v) {
+            BIN2BCD = v;
+            return BIN2BCD.get();
+        }
+
+        /**
+         * Convert BCD to binary by hardware
+         * @param v BCD value
+         * @return binary value
+         */
+        inline u16 from_bcd(u16 v) {
+            BCD2BIN = v;
+            return BCD2BIN.get();
+        }
+    };
+}  // namespace MSP430::Driver::RTC
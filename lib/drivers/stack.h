@@ -0,0 +1,63 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+
+namespace MSP430::Stack {
+    extern "C" {
+        extern u16  __bssend[];      //!< end of .bss, lowest free RAM word
+        extern u16  __stack[];       //!< top of stack (initial SP)
+        extern char __stack_size[];  //!< stack reserve, absolute symbol
+    }
+
+    /** Pattern written by `rt.S` to free RAM at reset */
+    static constexpr u16 PAINT = 0x5AA5;
+
+    /**
+     * Stack reserve set in the linker script
+     * @return bytes
+     */
+    inline u16 reserve() { return (u16)(__UINTPTR_TYPE__)__stack_size; }
+
+    /**
+     * Current stack depth
+     * @return bytes
+     */
+    inline u16 depth() {
+        u16 sp;
+        __asm__ volatile("mov.w sp, %0" : "=r"(sp));
+        return (u16)(__UINTPTR_TYPE__)__stack - sp;
+    }
+
+    /**
+     * Deepest stack use since reset, found as the lowest word that no
+     * longer holds the paint pattern. A frame may skip words without
+     * writing them, so treat it as a close lower bound.
+     * @return bytes
+     */
+    inline u16 high_water() {
+        const u16 *p = __bssend;
+        while (p < __stack && *p == PAINT)
+            p++;
+        return (u16)((__stack - p) * sizeof(u16));
+    }
+
+    /**
+     * Stack never grew past its reserve
+     */
+    inline bool within_reserve() { return high_water() <= reserve(); }
+
+    /**
+     * Guard word right above .bss is intact, i.e. the stack has never
+     * reached static data. Cheap enough for a periodic check in the main
+     * loop or a watchdog handler.
+     */
+    inline bool guard_ok() { return __bssend[0] == PAINT; }
+}  // namespace MSP430::Stack
@@ -59,6 +59,39 @@ namespace MSP430::Driver::Timer {
             TBIFG_P = 0b1 << 0,  //!< Interrupt pending
         };
 
+        enum CCTLe : u16 {
+            CM_M       = 0b11u << 14,  //!< Capture mode
+            CM_NONE    = 0b00u << 14,  //!< No capture
+            CM_RISING  = 0b01u << 14,  //!< Capture on rising edge
+            CM_FALLING = 0b10u << 14,  //!< Capture on falling edge
+            CM_BOTH    = 0b11u << 14,  //!< Capture on both edges
+
+            CCIS_M   = 0b11 << 12,  //!< Capture/compare input select
+            CCIS_A   = 0b00 << 12,  //!< CCIxA
+            CCIS_B   = 0b01 << 12,  //!< CCIxB
+            CCIS_GND = 0b10 << 12,  //!< GND
+            CCIS_VCC = 0b11 << 12,  //!< VCC
+
+            SCS = 1 << 11,  //!< Synchronize capture source to timer clock
+            CAP = 1 << 8,   //!< Capture mode (otherwise compare mode)
+
+            OUTMOD_M            = 0b111 << 5,  //!< Output mode
+            OUTMOD_OUT          = 0b000 << 5,  //!< OUT bit value
+            OUTMOD_SET          = 0b001 << 5,  //!< Set
+            OUTMOD_TOGGLE_RESET = 0b010 << 5,  //!< Toggle/reset
+            OUTMOD_SET_RESET    = 0b011 << 5,  //!< Set/reset
+            OUTMOD_TOGGLE       = 0b100 << 5,  //!< Toggle
+            OUTMOD_RESET        = 0b101 << 5,  //!< Reset
+            OUTMOD_TOGGLE_SET   = 0b110 << 5,  //!< Toggle/set
+            OUTMOD_RESET_SET    = 0b111 << 5,  //!< Reset/set
+
+            CCIE  = 1 << 4,  //!< Capture/compare interrupt enable
+            CCI   = 1 << 3,  //!< Capture/compare input, read only
+            OUT   = 1 << 2,  //!< Output value in output mode 0
+            COV   = 1 << 1,  //!< Capture overflow
+            CCIFG = 1 << 0,  //!< Capture/compare interrupt flag
+        };
+
         IOREG<u16, addr + 0x00> CTL;
         IOREG<u16, addr + 0x10> R;
         IOREG<u16, addr + 0x20> EX0;
@@ -77,6 +110,42 @@ namespace MSP430::Driver::Timer {
             IOREG<u16, addr + 0x12 + 2 * nr> r;
             return r;
         }
+
+        /**
+         * Clear and start counting, taking the clock request with `Power`.
+         * A running timer is stopped first.
+         * @param ctl `CLK_*` | `DIV_*` | mode, with `TBIE_E` if wanted
+         */
+        inline void start(u16 ctl) {
+            stop();
+            CTL = TBCLR;
+            CTL = ctl;
+            if (ctl & MODE_M)
+                Power::request(need());
+        }
+
+        /**
+         * Stop counting and drop the request taken by `start()`. Other
+         * settings are kept.
+         */
+        inline void stop() {
+            if (CTL || MODE_M) {
+                Power::release(need());
+                CTL &= ~MODE_M;
+            }
+        }
+
+        /**
+         * Clock this timer needs while running, for `Power::governor`
+         * @return need, `RETENTION` for external clock
+         */
+        inline NEED need() {
+            switch (CTL.get() & CLK_M) {
+                case CLK_SM: return NEED::SMCLK;
+                case CLK_A: return NEED::ACLK;
+                default: return NEED::RETENTION;
+            }
+        }
     };
 
     /**
@@ -151,5 +220,23 @@ namespace MSP430::Driver::Timer {
             TBIFG_N = 0b0 << 0,  //!< No interrupt pending
             TBIFG_P = 0b1 << 0,  //!< Interrupt pending
         };
+
+        enum CCTLBe : u16 {
+            //! Compare latch load (TB only, replaces SCCI)
+            CLLD_M = 0b11 << 9,
+
+            //! TBxCLn loads on write to TBxCCRn
+            CLLD_WRITE = 0b00 << 9,
+
+            //! TBxCLn loads when TBxR counts to 0
+            CLLD_ZERO = 0b01 << 9,
+
+            //! TBxCLn loads when TBxR counts to 0 (up or continuous mode),
+            //! or to TBxCL0 or 0 (up/down mode)
+            CLLD_ZERO_CL0 = 0b10 << 9,
+
+            //! TBxCLn loads when TBxR counts to TBxCL0
+            CLLD_CL0 = 0b11 << 9,
+        };
     };
 }  // namespace MSP430::Driver::Timer
@@ -0,0 +1,222 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "crc.h"
+#include "imath.h"
+#include "mpy32.h"
+
+/**
+ * Factory calibration from the device descriptor (TLV) at 0x1A00. After an
+ * info block of two words and a CRC (`CHECKSUM`) over the rest of the
+ * 256 bytes, entries are `tag`, `length`, `length` bytes of data.
+ *
+ * `calibration::load()` checks the CRC with the CRC16 module and finds the
+ * ADC12_B and REF entries at boot. Multipliers are computed from them once
+ * and kept with the CRC they came from, in FRAM, so later boots only check
+ * the CRC. Per sample, correction is one multiplication on MPY32:
+ *
+ *     TLV::calibration cal DATA_PERSISTENT;
+ *
+ *     cal.load();
+ *     const TLV::scale &s = cal[TLV::VREF::_1V2];
+ *     i16 counts = s.correct(adc12.mem<0>().get());
+ *     i16 temp   = s.centi_celsius(adc12.mem<1>().get());
+ *
+ * The FR5994 descriptor has no DCO constants, its DCO is trimmed in
+ * hardware. `src/TlvBench.cpp` measures cycles per sample.
+ */
+namespace MSP430::TLV {
+    static constexpr u16 BASE     = 0x1A00;
+    static constexpr u16 CHECKSUM = BASE + 0x02;  //!< CRC of `BASE + 4..END`
+    static constexpr u16 FIRST    = BASE + 0x08;  //!< First tag
+    static constexpr u16 END      = BASE + 0x100;
+
+    enum TAG : u8 {
+        DIE   = 0x08,  //!< Lot, wafer, die position
+        ADC12 = 0x11,  //!< ADC12_B calibration, `adc12_cal`
+        REF   = 0x12,  //!< REF_A calibration, `ref_cal`
+        NONE  = 0xFF,  //!< Erased, end of entries
+    };
+
+    /**
+     * ADC12_B entry. Temperature sensor readings at 30 and 85 degrees C,
+     * 12 bits, with each internal reference.
+     */
+    struct adc12_cal {
+        u16 gain;    //!< Q15
+        i16 offset;  //!< counts
+        u16 t30_1v2;
+        u16 t85_1v2;
+        u16 t30_2v0;
+        u16 t85_2v0;
+        u16 t30_2v5;
+        u16 t85_2v5;
+    };
+
+    /**
+     * REF_A entry, factors of the internal references, Q15
+     */
+    struct ref_cal {
+        u16 f_1v2;
+        u16 f_2v0;
+        u16 f_2v5;
+    };
+
+    /**
+     * Reference of the conversions
+     */
+    enum class VREF : u8 {
+        AVCC,  //!< AVCC or external, gain and offset only
+        _1V2,
+        _2V0,
+        _2V5,
+    };
+
+    /**
+     * CRC of the descriptor is intact. Done by the module as TI states
+     * it: seed 0xFFFF, words through `CRCDI`.
+     */
+    static inline bool valid() {
+        Driver::CRC::crc<0x150> crc;
+        crc.seed();
+        for (u16 a = BASE + 0x04; a < END; a += 2)
+            crc.DI = *(const volatile u16 *)a;
+        return crc.result() == *(const volatile u16 *)CHECKSUM;
+    }
+
+    /**
+     * Find an entry
+     * @param tag entry wanted
+     * @param size minimum length of its data
+     * @return data, `nullptr` if missing or too short
+     */
+    static inline const void *find(TAG tag, u8 size) {
+        const u8 *p = (const u8 *)FIRST;
+        while (p + 2 <= (const u8 *)END && p[0] != NONE) {
+            const u8 *next = p + 2 + p[1];
+            if (next > (const u8 *)END)
+                break;
+            if (p[0] == tag)
+                return p[1] >= size ? p + 2 : nullptr;
+            p = next;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Correction for one reference, from `calibration`
+     */
+    struct scale {
+        static constexpr u8 SLOPE_BITS = 10;
+
+        u16 gain;    //!< ADC gain times reference factor, Q15
+        i16 offset;  //!< ADC offset, counts
+        u16 t30;     //!< temperature sensor reading at 30 degrees C
+        i16 slope;   //!< centidegrees per count, Q10; 0 for AVCC
+
+        /**
+         * Gain and offset corrected conversion, as TI's
+         * `raw * gain / 2^15 + offset`, with the product rounded to
+         * nearest. No clamping: results slightly below 0 or above 4095
+         * come out as they are.
+         * @param raw unsigned 12-bit result
+         */
+        inline i16 correct(u16 raw) const {
+            u32 p = Driver::MPY32::mul((u16)(raw << 1), gain) + 0x8000;
+            return (i16)((u16)(p >> 16) + offset);
+        }
+
+        /**
+         * Temperature sensor reading (raw, same reference) in 0.01 degree C
+         */
+        inline i16 centi_celsius(u16 raw) const {
+            Driver::MPY32::mpy32<0x4C0> hw;
+            atomic                      g;
+            hw.MPYS = raw - t30;
+            hw.OP2  = (u16)slope;
+            u16 lo  = hw.RESLO.get();
+            u16 hi  = hw.RESHI.get();
+            return (i16)((hi << (16 - SLOPE_BITS)) | (lo >> SLOPE_BITS))
+                   + 3000;
+        }
+    };
+
+    /**
+     * Corrections for all references. Declare `DATA_PERSISTENT`, so the
+     * cache survives resets.
+     */
+    struct calibration {
+        static constexpr u16 MAGIC = 0x4354;  //!< "TC"
+
+        u16   magic;    //!< `MAGIC` when `ref` is computed, written last
+        u16   tlv_crc;  //!< descriptor CRC `ref` was computed from
+        scale ref[4];   //!< by `VREF`
+
+        inline const scale &operator[](VREF r) const { return ref[(u8)r]; }
+
+        /**
+         * Check the descriptor, compute corrections unless cached
+         * @return false if the descriptor is damaged or lacks ADC12_B and
+         * REF entries; corrections then pass readings through unchanged
+         */
+        bool load() {
+            u16 stored = *(const volatile u16 *)CHECKSUM;
+            if (!valid())
+                return identity();
+            if (magic == MAGIC && tlv_crc == stored)
+                return true;
+
+            auto *adc = (const adc12_cal *)find(ADC12, sizeof(adc12_cal));
+            auto *vr  = (const ref_cal *)find(REF, sizeof(ref_cal));
+            if (!adc || !vr)
+                return identity();
+
+            magic = 0;
+            set(VREF::AVCC, adc, 0x8000, 0, 0);
+            set(VREF::_1V2, adc, vr->f_1v2, adc->t30_1v2, adc->t85_1v2);
+            set(VREF::_2V0, adc, vr->f_2v0, adc->t30_2v0, adc->t85_2v0);
+            set(VREF::_2V5, adc, vr->f_2v5, adc->t30_2v5, adc->t85_2v5);
+            tlv_crc = stored;
+            magic   = MAGIC;
+            return true;
+        }
+
+      private:
+        bool identity() {
+            magic = 0;
+            for (scale &s : ref)
+                s = {0x8000, 0, 0, 0};
+            return false;
+        }
+
+        /**
+         * `slope` is `5500 << 10 / (t85 - t30)`, fitting `i16` for more
+         * than 171 counts between the points; none or fewer (no reference)
+         * leaves temperature at 30 degrees C
+         */
+        void set(VREF r, const adc12_cal *adc, u16 factor, u16 t30,
+                 u16 t85) {
+            scale &s = ref[(u8)r];
+            u32    g = Driver::MPY32::mul(adc->gain, factor) + 0x4000;
+            s.gain   = (u16)(g >> 15);
+            s.offset = adc->offset;
+            s.t30    = t30;
+            s.slope  = 0;
+            if (t85 > t30 + 171) {
+                u16 d = t85 - t30;
+                u16 rem;
+                s.slope =
+                    (i16)Math::div32((5500ul << scale::SLOPE_BITS) + d / 2,
+                                     d, rem);
+            }
+        }
+    };
+}  // namespace MSP430::TLV
@@ -126,7 +126,7 @@ namespace MSP430 {
             static constexpr u8  sizeInBits = 8 * sizeof(reg);
             static constexpr reg allOnes    = ~(reg)0u;
             static constexpr reg bitMask = allOnes >> (sizeInBits - bitLength);
-            static_assert(lowBit + bitLength < sizeInBits,
+            static_assert(lowBit + bitLength <= sizeInBits,
                           "IOBITRANGE falls of register");
             static_assert(bitLength > 0, "IOBITRANGE null length");
 
@@ -167,7 +167,7 @@ namespace MSP430 {
              */
             inline void set_atomic(reg in = bitMask) {
                 reg tmp = ref();
-                tmp &= ((reg)(~bitMask)) << lowBit;
+                tmp &= ~(bitMask << lowBit);
                 tmp |= (in & bitMask) << lowBit;
                 ref() = tmp;
             }
@@ -350,9 +350,54 @@ namespace MSP430 {
             inline bool operator||(reg mask) { return (ref() & mask) != 0; }
         };
 
+        /**
+         * Image of 20-bit address register of device (like DMA SA/DA).
+         * Register occupies two words, and is always written with a single
+         * `MOVX.A`, so both halves are updated at once.
+         * @tparam addr address of register
+         */
+        template <u16 addr>
+        struct IOREG20 {
+          private:
+            typedef IOREG20<addr> self;
+            inline volatile u32 & ref() { return *((volatile u32 *)addr); }
+
+          public:
+            /**
+             * Set new address to register
+             * @param p pointer anywhere in 1 MiB address space
+             */
+            inline void set(const volatile void *p) {
+                __asm__ volatile("movx.a %1, %0" : "=m"(ref()) : "r"(p));
+            }
+
+            /**
+             * Assign new address to register
+             * @param p pointer anywhere in 1 MiB address space
+             * @return
+             */
+            inline self &operator=(const volatile void *p) {
+                set(p);
+                return *this;
+            }
+
+            /**
+             * Get value of register
+             * @return 20-bit address, zero-extended
+             */
+            inline u32 get() { return ref() & 0xFFFFFul; }
+        };
+
     }  // namespace Tools
 
     namespace SR {
+        /** Missing intrinsic to read SR/r2 register */
+        inline u16 get() {
+            u16 sr;
+            __asm__ volatile("mov.w sr, %0" : "=r"(sr));
+            return sr;
+        }
+
         /** Missing intrinsic to set bits in SR/r2 register */
         inline void set(u16 mask) {
             __asm__ volatile("bis.w %0, sr" ::"i"(mask));
@@ -374,6 +419,17 @@ namespace MSP430 {
 
     enum class POWER { MODE0, MODE1, MODE2, MODE3, MODE4 };
 
+    /**
+     * What an active peripheral needs kept running while the CPU idles,
+     * from the most to the least demanding. See `Power::request()`.
+     */
+    enum class NEED : u8 {
+        CPU,        //!< Must not sleep at all (e.g. busy polling)
+        SMCLK,      //!< SMCLK running, allows LPM0/LPM1
+        ACLK,       //!< ACLK running, allows LPM3
+        RETENTION,  //!< RAM and registers kept, allows LPM4
+    };
+
     void enable_interrupts() {
         __asm__ volatile("nop");
         SR::set(1u << 3u);
@@ -386,6 +442,48 @@ namespace MSP430 {
         __asm__ volatile("nop");
     }
 
+    /**
+     * Interrupts off while in scope, previous state restored on exit.
+     * Guards may nest.
+     */
+    struct atomic {
+        u16 sr;
+
+        inline atomic() : sr(SR::get()) { disable_interrupts(); }
+
+        inline ~atomic() {
+            if (sr & (1u << 3u))
+                enable_interrupts();
+        }
+    };
+
+    namespace Power {
+        /**
+         * Outstanding requests per `NEED`. Drivers take one when they start
+         * and drop it when they stop, `Power::governor` reads them.
+         */
+        inline u8 needs[(u8)NEED::RETENTION + 1];
+
+        /**
+         * Add a request, also from interrupt handlers
+         * @param n what is needed
+         */
+        inline void request(NEED n) {
+            atomic g;
+            needs[(u8)n]++;
+        }
+
+        /**
+         * Drop a request added with `request()`
+         * @param n what was needed
+         */
+        inline void release(NEED n) {
+            atomic g;
+            if (needs[(u8)n])
+                needs[(u8)n]--;
+        }
+    }  // namespace Power
+
     void set_low_power(POWER mode) {
         enum u16 {
             GIE    = 1u << 3u,
@@ -427,7 +525,7 @@ namespace MSP430 {
         static constexpr u8 sizeInBits = 8 * sizeof(cell);
         static constexpr cell allOnes  = ~(cell)0u;
         static constexpr cell bitMask  = allOnes >> (sizeInBits - bitLength);
-        static_assert(lowBit + bitLength < sizeInBits,
+        static_assert(lowBit + bitLength <= sizeInBits,
                       "mask_write falls of register");
         static_assert(bitLength > 0, "mask_write null length");
 
@@ -0,0 +1,136 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "timer.h"
+
+#define TRACE_STR_(x) #x
+#define TRACE_STR(x)  TRACE_STR_(x)
+
+/**
+ * Put a trace record. Format string and source location go to the
+ * non-loaded `.trace.fmt` section, the record holds only the string offset
+ * there as event id, so they cost no target memory. `tools/tracedump.py`
+ * reads them back from the ELF file.
+ *
+ *     TRACE(trace, "adc overrun, level %u", level);
+ *
+ * @param buf trace buffer
+ * @param fmt string literal, printf-like with at most one argument
+ * @param arg 32-bit argument
+ */
+#define TRACE(buf, fmt, arg)                                                   \
+    do {                                                                       \
+        static const char trace_fmt_[]                                         \
+            __attribute((section(".trace.fmt"), used)) =                       \
+                fmt "\0" __FILE__ ":" TRACE_STR(__LINE__);                     \
+        (buf).put((MSP430::u16)(__UINTPTR_TYPE__)trace_fmt_,                   \
+                  (MSP430::u32)(arg));                                         \
+    } while (0)
+
+namespace MSP430::Trace {
+    /**
+     * Single trace record
+     */
+    struct record {
+        u16 stamp;  //!< time source ticks
+        u16 id;     //!< offset of format string in `.trace.fmt`
+        u32 arg;
+    };
+
+    /**
+     * Free-running Timer_A as trace time source. Start it with `start()`,
+     * e.g. from ACLK for a 2 s wrap at 32768 Hz.
+     * @tparam addr base address of timer
+     * @tparam ccrCount capture register count for this specific timer
+     */
+    template <u16 addr, u8 ccrCount>
+    struct timer {
+        typedef Driver::Timer::TA<addr, ccrCount> TA;
+
+        static void start(u16 clock = TA::CLK_A | TA::DIV_1) {
+            TA t;
+            t.start(clock | TA::CONT);
+        }
+
+        static inline u16 now() {
+            TA t;
+            return t.R.get();
+        }
+    };
+
+    /**
+     * Circular trace buffer, meant to be placed in FRAM with
+     * `DATA_PERSISTENT_HIGH` so the last `N` events survive reset:
+     *
+     *     Trace::buffer<Trace::timer<0x7C0, 2>, 256> trace
+     *         DATA_PERSISTENT_HIGH;
+     *
+     * A record costs a timer read, four word writes and an index update,
+     * done with interrupts disabled so trace points may be used in ISRs.
+     * @tparam Clock time source, type with `static u16 now()`
+     * @tparam N number of records, power of 2
+     */
+    template <typename Clock, u16 N>
+    struct buffer {
+        static_assert(N >= 2 && (N & (N - 1)) == 0, "N must be power of 2");
+
+        static constexpr u16 MAGIC = 0x5254;  //!< "TR"
+        static constexpr u16 MASK  = N - 1;
+
+        u16    magic;
+        u16    size;   //!< `N`, for decoder
+        u16    head;   //!< next record to write
+        u16    wraps;  //!< times `head` wrapped, saturating
+        record rec[N];
+
+        /**
+         * Call once at boot. Keeps content of an initialised buffer and
+         * marks the reset in it, so the decoder can split runs.
+         * @param reason reset cause, e.g. `SYSRSTIV`
+         */
+        void boot(u32 reason = 0) {
+            if (magic != MAGIC || size != N) {
+                head  = 0;
+                wraps = 0;
+                size  = N;
+                magic = MAGIC;
+            }
+            TRACE(*this, "--- boot, reason 0x%x ---", reason);
+        }
+
+        /**
+         * Drop all records
+         */
+        void clear() {
+            head  = 0;
+            wraps = 0;
+        }
+
+        /**
+         * Append record, overwriting the oldest one when full.
+         * Use `TRACE` macro instead of calling it directly.
+         * @param id event id
+         * @param arg argument
+         */
+        inline void put(u16 id, u32 arg) {
+            atomic  g;
+            u16     h = head;
+            record &r = rec[h];
+            r.stamp   = Clock::now();
+            r.id      = id;
+            r.arg     = arg;
+            h         = (h + 1) & MASK;
+            head      = h;
+            if (h == 0 && wraps != 0xFFFF)
+                wraps++;
+        }
+    };
+}  // namespace MSP430::Trace
@@ -0,0 +1,233 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "clock.h"
+#include "ring.h"
+
+namespace MSP430::Driver::UART {
+    using MSP430::Tools::IOREG;
+    using MSP430::Tools::ring;
+
+    /**
+     * Baud rate clock (`UCSSELx`)
+     */
+    enum class CLK : u16 {
+        ACLK  = 0b01 << 6,
+        SMCLK = 0b10 << 6,
+    };
+
+    namespace Detail {
+        typedef __UINT64_TYPE__ u64;
+
+        /**
+         * `UCBRSx` for a fractional part of the divider, in 1/10000
+         * (user's guide, table "UCBRSx settings for fractional portion")
+         */
+        static constexpr u8 modulation(u16 frac) {
+            constexpr u16 limit[] = {0,    529,  715,  835,  1001, 1252,
+                                     1430, 1670, 2147, 2224, 2503, 3000,
+                                     3335, 3575, 3753, 4003, 4286, 4378,
+                                     5002, 5715, 6003, 6254, 6432, 6667,
+                                     7001, 7147, 7503, 7861, 8004, 8333,
+                                     8464, 8572, 8751, 9004, 9170, 9288};
+            constexpr u8  brs[] = {0x00, 0x01, 0x02, 0x04, 0x08, 0x10,
+                                  0x20, 0x11, 0x21, 0x22, 0x44, 0x25,
+                                  0x49, 0x4A, 0x52, 0x92, 0x53, 0x55,
+                                  0xAA, 0x6B, 0xAD, 0xB5, 0xB6, 0xD6,
+                                  0xB7, 0xBB, 0xDD, 0xED, 0xEE, 0xBF,
+                                  0xDF, 0xEF, 0xF7, 0xFB, 0xFD, 0xFE};
+            u8 i = 0;
+            while (i + 1 < sizeof(brs) && limit[i + 1] <= frac)
+                i++;
+            return brs[i];
+        }
+    }  // namespace Detail
+
+    /**
+     * eUSCI_A in UART mode, 8N1, transmit side. Bytes go through a ring
+     * drained by the TX interrupt, so writers return at once unless the
+     * ring is full:
+     *
+     *     UART::uart<0x5C0> log;
+     *
+     *     IRQ_HANDLER(eUSCI_A0) { log.isr(); }
+     *
+     *     p2.set_function(GPIO::FUNCTION::F2, 0b11);  // P2.0 TXD, P2.1 RXD
+     *     log.start<UART::CLK::SMCLK, 8000000, 115200>();
+     *
+     * or, with SMCLK measured by `Clock::dco_trim`,
+     * `log.start<UART::CLK::SMCLK>(clocks, 115200)`.
+     *
+     * It is a sink for `Format::print()`. On a full ring a writer waits if
+     * interrupts are enabled, otherwise (in handlers) the byte is dropped
+     * and counted.
+     *
+     * @tparam addr base address of eUSCI_A (0x5C0, 0x5E0, 0x600, 0x620)
+     * @tparam N transmit ring size, power of 2
+     */
+    template <u16 addr, u16 N = 64>
+    struct uart {
+        enum CTLW0e : u16 {
+            SWRST = 1 << 0,  //!< Held in reset
+        };
+
+        enum MCTLWe : u16 {
+            OS16 = 1 << 0,  //!< Oversampling
+        };
+
+        enum STATWe : u16 {
+            BUSY = 1 << 0,  //!< Transmitting or receiving
+        };
+
+        enum IEe : u16 {
+            RXIE = 1 << 0,
+            TXIE = 1 << 1,
+        };
+
+        enum IFGe : u16 {
+            TXIFG = 1 << 1,  //!< `TXBUF` empty
+        };
+
+        static constexpr u16 IV_TX = 0x04;
+
+        IOREG<u16, addr + 0x00> CTLW0;
+        IOREG<u16, addr + 0x06> BRW;
+        IOREG<u16, addr + 0x08> MCTLW;
+        IOREG<u16, addr + 0x0A> STATW;
+        IOREG<u16, addr + 0x0C> RXBUF;
+        IOREG<u16, addr + 0x0E> TXBUF;
+        IOREG<u16, addr + 0x1A> IE;
+        IOREG<u16, addr + 0x1C> IFG;
+        IOREG<u16, addr + 0x1E> IV;
+
+        ring<u8, N> tx;
+        u16         dropped;  //!< bytes lost to a full ring in handlers
+
+        /**
+         * Configure baud rate, dividers are computed at compile time
+         * @tparam ClkSource clock of the baud rate generator
+         * @tparam clockHz its frequency
+         * @tparam baud bits per second, at most `clockHz / 3`
+         */
+        template <CLK ClkSource, u32 clockHz, u32 baud>
+        void start() {
+            static_assert(baud > 0 && clockHz >= 3 * baud, "baud too high");
+            constexpr Detail::u64 n   = (Detail::u64)clockHz * 10000 / baud;
+            constexpr u8          brs = Detail::modulation(n % 10000);
+            constexpr bool        os  = clockHz >= 16 * baud;
+            constexpr u16         br  = os ? clockHz / (16 * baud) : n / 10000;
+            constexpr u16         brf = os ? clockHz % (16 * baud) / baud : 0;
+            configure(ClkSource, br, brs, brf, os);
+        }
+
+        /**
+         * Configure baud rate for the measured frequency of its clock
+         * (`Clock::dco_trim`). Dividers are computed here, with libgcc
+         * division, so call it at setup, not per byte.
+         * @tparam ClkSource clock of the baud rate generator
+         * @param f measured frequencies, e.g. `FR5994::clocks`
+         * @param baud bits per second, at most a third of the clock
+         */
+        template <CLK ClkSource>
+        void start(const Clock::frequency &f, u32 baud) {
+            u32  clk = ClkSource == CLK::SMCLK ? f.smclk : f.aclk;
+            u32  n   = clk / baud;
+            u8   brs = Detail::modulation(
+                (u16)((Detail::u64)(clk - n * baud) * 10000 / baud));
+            bool os  = n >= 16;
+            u16  br  = os ? n >> 4 : n;
+            u16  brf = os ? (u16)(clk % (16 * baud) / baud) : 0;
+            configure(ClkSource, br, brs, brf, os);
+        }
+
+        /**
+         * Stop at once, unsent bytes are dropped
+         */
+        void stop() {
+            IE &= ~TXIE;
+            if (!(CTLW0 && SWRST))
+                Power::release(need());
+            CTLW0 = SWRST;
+            tx.clear();
+        }
+
+        /**
+         * Queue a byte
+         * @param c byte
+         */
+        void put(char c) {
+            while (!tx.push((u8)c)) {
+                if (!(SR::get() & (1u << 3u))) {
+                    dropped++;
+                    return;
+                }
+            }
+            // The handler that ran the ring dry took TXIFG with its `IV`
+            // read, TXBUF is empty since: set the flag to restart the drain
+            atomic g;
+            if (!(IE && TXIE)) {
+                IFG |= TXIFG;
+                IE |= TXIE;
+            }
+        }
+
+        /**
+         * Queue bytes
+         * @param s bytes
+         * @param n number of bytes
+         */
+        void write(const char *s, u16 n) {
+            while (n--)
+                put(*s++);
+        }
+
+        /**
+         * Wait until everything queued has left the shift register
+         */
+        void flush() {
+            while (!tx.empty() || (STATW && BUSY)) {
+            }
+        }
+
+        /**
+         * Interrupt handler body, one byte per TX interrupt
+         */
+        inline void isr() {
+            if (IV.get() != IV_TX)
+                return;
+            u8 c;
+            if (tx.pop(c))
+                TXBUF = c;
+            else
+                IE &= ~TXIE;
+        }
+
+        /**
+         * Clock the baud rate generator needs, for `Power::governor`
+         */
+        inline NEED need() {
+            if ((CTLW0.get() & (0b11 << 6)) == (u16)CLK::SMCLK)
+                return NEED::SMCLK;
+            return NEED::ACLK;
+        }
+
+      private:
+        void configure(CLK src, u16 br, u8 brs, u16 brf, bool os) {
+            stop();
+            dropped = 0;
+            CTLW0   = SWRST | (u16)src;
+            BRW     = br;
+            MCTLW   = ((u16)brs << 8) | (brf << 4) | (os ? OS16 : 0);
+            CTLW0   = (u16)src;
+            Power::request(need());
+        }
+    };
+}  // namespace MSP430::Driver::UART
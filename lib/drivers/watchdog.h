@@ -0,0 +1,172 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+#pragma once
+
+#include "tools.h"
+#include "delay.h"
+#include "wdt_a.h"
+
+namespace MSP430::Watchdog {
+    using MSP430::Driver::WDT_A::CLK;
+    using MSP430::Driver::WDT_A::INTERVAL;
+
+    /** Characters of a task name kept across reset */
+    static constexpr u8 NAME = 12;
+
+    /**
+     * Software watchdog over WDT_A. Each task has its own deadline and
+     * checks in with `kick()`; WDT_A stays a hardware watchdog and is only
+     * kicked while every task is current, so the first task to miss its
+     * deadline resets the device, after its name was written to `culprit`:
+     *
+     *     enum TASK : u8 { RADIO, SENSOR, TASKS };
+     *     Watchdog::supervisor<TASKS> dog DATA_PERSISTENT;
+     *
+     *     IRQ_HANDLER(TA3_CCR1) { dog.isr(); }
+     *
+     *     if (const char *t = dog.last()) report(t);  // previous reset
+     *     dog.start();
+     *     dog.attach(RADIO, "radio", 8);  // 8 ticks: 2 s at 250 ms
+     *     ...
+     *     dog.kick(RADIO);
+     *
+     * Checks run on CCR1 of `Clock`, the free-running ACLK timer of
+     * `Delay`, so they need no timer of their own. A hang with interrupts
+     * disabled, or in a handler of higher priority, stops the checks and
+     * so the kicks: WDT_A resets then too, with `culprit` left empty.
+     *
+     * Each check looks at one task, round-robin, so the handler takes
+     * constant time whatever the task count. `N` checks make a tick, so
+     * every task is visited once per tick and caught within a tick after
+     * its deadline. WDT_A is kicked after a round with no task late; the
+     * reset follows within its interval, which must be longer than a tick.
+     * Deadlines must stay below 32768 ticks. Place the supervisor in FRAM
+     * (`DATA_PERSISTENT`) to keep `culprit` over the reset; `start()` does
+     * not clear it.
+     *
+     * @tparam N number of task ids
+     * @tparam Clock tick source, `Delay::sleeper` whose CCR1 is not used
+     * elsewhere (e.g. by a `Debounce::debouncer` on the same timer)
+     * @tparam addr base address of WDT_A
+     */
+    template <u8 N, typename Clock = Delay::timer, u16 addr = 0x15C>
+    struct supervisor {
+        static_assert(N > 0);
+
+        typedef typename Clock::TA TA;
+
+        static constexpr u16 TICK    = 8192;      //!< ACLK periods: 250 ms
+        static constexpr u16 CHECK   = TICK / N;  //!< ACLK periods per check
+        static constexpr u16 IV_CCR1 = 0x02;
+
+        volatile u16 now;        //!< ticks since `start()`
+        u16          due[N];     //!< tick of deadline
+        u16          period[N];  //!< ticks allowed between kicks, 0: off
+        const char * name[N];
+        u8           next;  //!< task checked by next check
+        bool         late;  //!< a deadline was missed, reset pending
+
+        char culprit[NAME];  //!< task that missed its deadline, kept
+        u16  resets;         //!< resets by missed deadlines, kept
+
+        /**
+         * Drop all tasks, start the tick and WDT_A in watchdog mode
+         * @tparam ClkSource clock source of WDT_A
+         * @tparam Interval reset timeout, longer than a tick
+         */
+        template <CLK      ClkSource = CLK::ACLK,
+                  INTERVAL Interval = INTERVAL::T_1s>
+        void start() {
+            Driver::WDT_A::wdt_a<addr> w;
+            TA                         t;
+            for (u8 i = 0; i < N; i++)
+                period[i] = 0;
+            now  = 0;
+            next = 0;
+            late = false;
+            w.template restart<ClkSource, Interval>();
+            Clock::start();
+            t.template ccr<1>()  = Clock::now() + CHECK;
+            t.template cctl<1>() = TA::CCIE;
+        }
+
+        /**
+         * Watch a task, its first deadline is `ticks` from now
+         * @param id task id
+         * @param task name, kept in `culprit` on reset
+         * @param ticks ticks allowed between kicks, 1..32767
+         */
+        void attach(u8 id, const char *task, u16 ticks) {
+            name[id]   = task;
+            due[id]    = now + ticks;
+            period[id] = ticks;
+        }
+
+        /**
+         * Stop watching a task
+         * @param id task id
+         */
+        inline void detach(u8 id) { period[id] = 0; }
+
+        /**
+         * Task is alive, move its deadline
+         * @param id task id
+         */
+        inline void kick(u8 id) { due[id] = now + period[id]; }
+
+        /**
+         * Task that caused the previous reset
+         * @return name, or null if none since `clear()`
+         */
+        inline const char *last() { return culprit[0] ? culprit : nullptr; }
+
+        /**
+         * Forget the recorded task and reset count
+         */
+        inline void clear() {
+            culprit[0] = 0;
+            resets     = 0;
+        }
+
+        /**
+         * Check (`Clock` CCR1 interrupt) handler body
+         */
+        inline void isr() {
+            Driver::WDT_A::wdt_a<addr> w;
+            TA                         t;
+            if (t.IV.get() != IV_CCR1)
+                return;
+            t.template ccr<1>() = t.template ccr<1>().get() + CHECK;
+            u8 i = next;
+            if (period[i] && (i16)(now - due[i]) > 0)
+                miss(i);
+            if (i + 1 < N) {
+                next = i + 1;
+                return;
+            }
+            next = 0;
+            now  = now + 1;
+            if (!late)
+                w.kick();
+        }
+
+      private:
+        NOINLINE void miss(u8 i) {
+            if (late)
+                return;
+            late          = true;
+            const char *s = name[i];
+            u8          k = 0;
+            for (; k < NAME - 1 && s[k]; k++)
+                culprit[k] = s[k];
+            culprit[k] = 0;
+            resets++;
+        }
+    };
+}  // namespace MSP430::Watchdog
@@ -81,12 +81,19 @@ namespace MSP430::Driver::WDT_A {
         inline void write(u16 val) { WDCTL = (CTL::PW | (val & 0xFF)); }
 
         /**
-         * Stop watchdog
+         * Stop watchdog, dropping the request taken by `restart()`
          */
-        inline void stop() { write(CTL::HOLD); }
+        inline void stop() {
+            write(CTL::HOLD);
+            if (taken)
+                Power::release((NEED)(taken - 1));
+            taken = 0;
+        }
 
         /**
-         * (re)start watchdog
+         * (re)start watchdog, taking a request for its clock with `Power`.
+         * The request changes only with the clock source, so this also
+         * serves as a kick. The watchdog running from reset holds none.
          * default template parameters give *1s timeout* on demo board
          * @tparam ClkSource clock source for counter
          * @tparam Interval range of counter
@@ -96,6 +103,58 @@ namespace MSP430::Driver::WDT_A {
                   INTERVAL Interval = INTERVAL::T_1s, MODE Mode = MODE::WD>
         inline void restart() {
             write((u16)ClkSource | (u16)Interval | (u16)Mode | CTL::CLR);
+            u8 n = (u8)need() + 1;
+            if (n == taken)
+                return;
+            if (taken)
+                Power::release((NEED)(taken - 1));
+            Power::request(need());
+            taken = n;
         }
+
+        /**
+         * Clear the counter, settings are kept
+         */
+        inline void kick() { write(WDCTL.get() | CTL::CLR); }
+
+        /**
+         * Run as interval timer: no reset, `WDT` interrupt at every
+         * interval. The flag clears itself when the vector is taken.
+         * @tparam ClkSource clock source for counter
+         * @tparam Interval range of counter
+         */
+        template <CLK      ClkSource = CLK::ACLK,
+                  INTERVAL Interval = INTERVAL::T_250ms>
+        inline void interval() {
+            restart<ClkSource, Interval, MODE::TIM>();
+            SFRIE1 |= WDTIE;
+        }
+
+        /**
+         * Reset the device at once: a write without password causes PUC
+         */
+        [[noreturn]] inline void reset() {
+            WDCTL = 0;
+            while (true) {
+            }
+        }
+
+        /**
+         * Clock the counter needs while running, for `Power::governor`
+         */
+        inline NEED need() {
+            if ((WDCTL.get() & (0b11 << 5)) == (u16)CLK::SMCLK)
+                return NEED::SMCLK;
+            return NEED::ACLK;
+        }
+
+      private:
+        enum : u16 {
+            WDTIE = 1 << 0,  //!< SFRIE1: interval timer interrupt enable
+        };
+
+        static inline u8 taken;  //!< `NEED` + 1 requested by `restart()`
+
+        IOREG<u16, 0x100> SFRIE1;  //!< SFR interrupt enable, at fixed address
     };
 }  // namespace MSP430::Driver::WDT_A
@@ -9,18 +9,61 @@
 #pragma once
 
 #include "drivers/tools.h"
+#include "drivers/adc12.h"
+#include "drivers/boot.h"
+#include "drivers/capture.h"
 #include "drivers/clock.h"
+#include "drivers/comp_e.h"
+#include "drivers/crc.h"
+#include "drivers/debounce.h"
+#include "drivers/delay.h"
+#include "drivers/dma.h"
+#include "drivers/dsp.h"
+#include "drivers/far.h"
+#include "drivers/format.h"
+#include "drivers/fram.h"
 #include "drivers/gpio.h"
+#include "drivers/imath.h"
+#include "drivers/lz.h"
+#include "drivers/mpu.h"
+#include "drivers/mpy32.h"
+#include "drivers/pattern.h"
+#include "drivers/pins.h"
 #include "drivers/pmm.h"
+#include "drivers/power.h"
+#include "drivers/profile.h"
+#include "drivers/pwm.h"
+#include "drivers/rtc.h"
+#include "drivers/stack.h"
 #include "drivers/timer.h"
+#include "drivers/tlv.h"
+#include "drivers/trace.h"
+#include "drivers/uart.h"
+#include "drivers/watchdog.h"
 #include "drivers/wdt_a.h"
 
 namespace MSP430::FR5994 {
     using namespace Driver;
 
-    Driver::WDT_A::wdt_a<0x15C> wdt_a;
-    Driver::PMM::pmm<0x120>     pmm;
-    Driver::Clock::cs<0x160>    cs;
+    Driver::WDT_A::wdt_a<0x15C>   wdt_a;
+    Driver::PMM::pmm<0x120>       pmm;
+    Driver::Clock::cs<0x160>      cs;
+    Driver::DMA::dma<0x500>       dma;
+    Driver::FRAM::frctl<0x140>    frctl;
+    Driver::RTC::rtc<0x4A0>       rtc;
+    Driver::COMP_E::comp_e<0x8C0> comp_e;
+    Driver::MPU::mpu<0x5A0>       mpu;
+    Driver::MPY32::mpy32<0x4C0>   mpy32;
+    Driver::ADC12::adc12<0x800>   adc12;
+    Driver::CRC::crc<0x150>       crc;
+
+    /**
+     * Clock frequencies: nominal after `cs.nominal(clocks)`, measured
+     * after `dco`. Not persistent, a reset reverts the clock setup too.
+     */
+    Driver::Clock::frequency clocks;
+    /** Fills `clocks`, borrows `ta0` while measuring */
+    Driver::Clock::dco_trim<0x160, 0x340, 3> dco;
 
     Driver::GPIO::port_int<0x200>    p1;
     Driver::GPIO::port_int<0x201>    p2;
@@ -32,9 +75,14 @@ namespace MSP430::FR5994 {
     Driver::GPIO::port_int<0x261>    p8;
     Driver::GPIO::port_simple<0x320> pj;
 
+    Driver::GPIO::port_pair<0x200> pa;
+    Driver::GPIO::port_pair<0x220> pb;
+    Driver::GPIO::port_pair<0x240> pc;
+    Driver::GPIO::port_pair<0x260> pd;
+
     Driver::Timer::TA<0x340, 3> ta0;
     Driver::Timer::TA<0x380, 3> ta1;
-    Driver::Timer::TA<0x380, 2> ta2;
+    Driver::Timer::TA<0x400, 2> ta2;
     Driver::Timer::TA<0x440, 2> ta3;
     Driver::Timer::TA<0x7C0, 2> ta4;
     Driver::Timer::TB<0x3C0, 7> tb0;
@@ -13,12 +13,6 @@
 using namespace MSP430::FR5994;
 using MSP430::u16, MSP430::u8;
 
-NOINLINE void delay(u16 n) {
-    static volatile unsigned int i DATA_TINY = 0;
-    for (i = 0; i < n; i++)
-        ;
-}
-
 int main() {
     using MSP430::Driver::Clock::ACLK, MSP430::Driver::Clock::MCLK,
         MSP430::Driver::Clock::DIV, MSP430::Driver::Clock::DCO;
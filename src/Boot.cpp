@@ -0,0 +1,36 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Resident boot stage of the A/B image layout (see `drivers/boot.h`),
+// flashed once. Starts the newest valid image; with none, lights the red
+// LED and sleeps in LPM4.
+//
+// Images are checked with MCLK at 8 MHz: the CRC module takes one byte
+// per few cycles, roughly a millisecond per 1.5 KiB of image. MCLK is back
+// at its reset value when the image starts.
+
+#include <msp430fr5994.h>
+
+using namespace MSP430::FR5994;
+using MSP430::Driver::Clock::DIV, MSP430::Driver::Clock::MCLK;
+
+int main() {
+    wdt_a.stop();
+
+    cs.Update().Set_MCLK(MCLK::DCOCLK, DIV::_1);
+    const MSP430::Boot::header *h = MSP430::Boot::image::select();
+    cs.Update().Set_MCLK(MCLK::DCOCLK, DIV::_8);
+    if (h)
+        MSP430::Boot::image::start(h);
+
+    p1.OUT = 0b01;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b01);
+    pmm.unlock_pm5();
+    while (true)
+        set_low_power(MSP430::POWER::MODE4);
+}
@@ -51,8 +51,202 @@ NOINLINE MSP430::u8 bit_range() {
     return (MSP430::u8)p2.IN.bits<2, 6>();
 }
 
+//------------------------
+// 16-bit port pairs
+NOINLINE void port_pair() {
+    using MSP430::Driver::GPIO::MODE;
+
+    // PA is P1 (bits 0..7) and P2 (bits 8..15) as single 16-bit port
+    pa.set_mode(MODE::OUT, 0xFFFF);
+
+    // Whole 16-bit bus pattern in a single `mov.w`
+    pa.OUT = 0xBEEF;
+
+    // Bit ranges may span both halves of a pair
+    pb.OUT.bits<4, 11>() = 0x5A;
+}
+
+//------------------------
+// Compile-time pins and pin groups
+NOINLINE void pin_group() {
+    using namespace MSP430::Driver::GPIO;
+
+    using LedRed   = Pin<decltype(p1), 0>;
+    using LedGreen = Pin<decltype(p1), 1>;
+    using Strobe   = Pin<decltype(p2), 7>;
+    using Enable   = Pin<decltype(p4), 2>;
+
+    // Pins are merged per port at compile time: P1 and P2 share port pair PA,
+    // so the whole group costs one word access to PA and one byte access
+    // to P4 per register.
+    using Bus = PinGroup<LedRed, LedGreen, Strobe, Enable>;
+
+    Bus::configure(MODE::OUT);
+    Bus::write(0b1010);  // bit 0 -> P1.0, bit 1 -> P1.1, bit 2 -> P2.7, ...
+    LedRed::toggle();
+}
+
+//------------------------
+// Threshold wake-up with Comparator_E
+NOINLINE void threshold_wake() {
+    using MSP430::Driver::COMP_E::EDGE, MSP430::Driver::COMP_E::FILTER,
+        MSP430::Driver::COMP_E::POWER, MSP430::Driver::COMP_E::REFERENCE;
+
+    // Sensor on C2, wake when it crosses 2.0 V * 20/32 = 1.25 V upwards,
+    // re-arm only after it falls below 2.0 V * 17/32 = 1.06 V
+    comp_e.input(2);
+    comp_e.threshold(REFERENCE::V_2_0, 19, 16);
+    comp_e.on(POWER::ULTRA_LOW, FILTER::US_1_8);
+    comp_e.enable_irq(EDGE::RISING);
+}
+
+//------------------------
+// Stack monitoring
+NOINLINE bool stack_check() {
+    namespace Stack = MSP430::Stack;
+
+    // Free RAM is painted at reset. The guard word sits right above .bss,
+    // high water mark is the deepest stack use seen so far.
+    return Stack::guard_ok() && Stack::high_water() <= Stack::reserve();
+}
+
+//------------------------
+// FRAM protection with MPU
+MSP430::u16 violations DATA_PERSISTENT = 0;
+
+IRQ_HANDLER(System_NMI) { violations |= mpu.isr(); }
+
+NOINLINE void memory_protection() {
+
+    // Code is execute-only, constants read-only, persistent data read/write.
+    // Writes to `DATA_PERSISTENT` variables need no unlocking.
+    mpu.start();
+    violations = 0;
+}
+
+//------------------------
+// Delays
+IRQ_HANDLER(TA3_CCR0) { MSP430::Delay::timer::isr(); }
+
+NOINLINE void delays() {
+    using MSP430::Delay::delay_cycles, MSP430::Delay::delay_ms,
+        MSP430::Delay::delay_us;
+
+    // Exact busy waits, length fixed at compile time from MSP430_MCLK_HZ
+    p1.OUT.bit<0>() = 1;
+    delay_cycles<5>();  // jmp, jmp, nop
+    p1.OUT.bit<0>() = 0;
+    delay_us<50>();  // counting loop
+
+    // Long waits sleep in LPM3 until timer compare
+    delay_ms<250>();
+}
+
+//------------------------
+// Measured clocks
+NOINLINE void measured_clocks() {
+    // Nominal frequencies of the current setup, until measured
+    cs.nominal(clocks);
+
+    // Closest DCO setting to 8 MHz, measured against the 32768 Hz crystal
+    dco.tune(clocks, 8000000);
+
+    // Run-time delays from the measured MCLK
+    MSP430::Delay::delay_us(clocks, 100);
+
+    // Re-measure when the temperature (any source) moved by 5 degrees
+    dco.retrim(clocks, 25);
+}
+
+//------------------------
+// Power-mode governor
+MSP430::Power::governor<MSP430::Delay::timer> power DATA_PERSISTENT;
+
+// Compare on TA1 ends each `idle()`
+IRQ_HANDLER(TA1_CCR0) {
+    ta1.cctl<0>() = 0;
+    MSP430::SR::clear_on_exit(0xF0);
+}
+
+NOINLINE void power_governor() {
+    power.start();
+
+    // Timer clocked from SMCLK keeps the CPU out of LPM2 and deeper
+    ta1.start(ta1.CLK_SM | ta1.DIV_8 | ta1.CONT);
+    ta1.ccr<0>()  = 1000;
+    ta1.cctl<0>() = ta1.CCIE;
+    power.idle();  // LPM1
+    ta1.stop();
+
+    // Same timer from ACLK, SMCLK may stop
+    ta1.start(ta1.CLK_A | ta1.DIV_1 | ta1.CONT);
+    ta1.ccr<0>()  = 1000;
+    ta1.cctl<0>() = ta1.CCIE;
+    power.idle();  // LPM3
+    ta1.stop();
+}
+
+//------------------------
+// Software watchdog
+enum TASK : MSP430::u8 { SAMPLING, LOGGING, TASKS };
+
+MSP430::Watchdog::supervisor<TASKS> dog DATA_PERSISTENT;
+
+IRQ_HANDLER(TA3_CCR1) { dog.isr(); }
+
+NOINLINE void software_watchdog() {
+    // Name of the task that missed its deadline before the last reset
+    if (dog.last())
+        dog.clear();
+
+    // Ticks every 250 ms from the delay timer, each task has its own
+    // deadline; WDT_A resets within 1 s of a missed one
+    dog.start();
+    dog.attach(SAMPLING, "sampling", 2);  // 500 ms
+    dog.attach(LOGGING, "logging", 40);   // 10 s
+
+    dog.kick(SAMPLING);
+    dog.detach(LOGGING);
+}
+
+//------------------------
+// Formatted output
+MSP430::Driver::UART::uart<0x5C0> console;
+
+IRQ_HANDLER(eUSCI_A0) { console.isr(); }
+
+NOINLINE void formatted_output() {
+    namespace Format = MSP430::Format;
+    using MSP430::Driver::UART::CLK;
+
+    p2.set_function(MSP430::Driver::GPIO::FUNCTION::F2, 0b11);  // P2.0, P2.1
+    console.start<CLK::SMCLK>(clocks, 9600);  // measured, see above
+    MSP430::enable_interrupts();
+
+    // Parsed at compile time: two literal writes and three emitter calls
+    MSP430::i16 gain = 0x2A3D;  // Q15
+    Format::print<"{} samples, status {x4}, gain {q15.4}\r\n">(
+        console, 1000u, adc12.IFGR0.get(), gain);
+
+    // Into a buffer, cut off to its size
+    char line[16];
+    MSP430::u16 n = Format::format<"id={x8}">(line, sizeof(line), 0xC0FFEEul);
+    console.write(line, n);
+    console.flush();
+}
+
 int main() {
     full_reg();
     bit_reg();
     bit_range();
+    port_pair();
+    pin_group();
+    threshold_wake();
+    stack_check();
+    memory_protection();
+    delays();
+    measured_clocks();
+    power_governor();
+    software_watchdog();
+    formatted_output();
 }
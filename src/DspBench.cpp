@@ -0,0 +1,169 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// DSP pipeline throughput benchmark, then live processing of ADC data.
+//
+// Each stage and the whole chain process `RUNS` synthetic blocks, in
+// pieces of `PIECE` samples timed one by one. `ta4` counts SMCLK == MCLK
+// cycles, so throughput in samples per second per MHz of MCLK is
+// `samples * 1000000 / cycles` of each `results.stage` entry.
+// Built twice: `DspBench` with CPU multiplies, `DspBenchMpy` with
+// `MSP430_DSP_MPY32`. Read results with `mspdebug ... "md results 64"`.
+//
+// Afterwards A2 (P1.2) is sampled at 8 kHz into DMA ping-pong buffers and
+// run through the chain; the red LED follows the threshold events.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::i16, MSP430::u16, MSP430::u32, MSP430::u8;
+namespace DSP = MSP430::DSP;
+
+static constexpr u16 BLOCK = 256;
+static constexpr u8  RUNS  = 16;
+/** Samples timed at once, so one piece stays well within 16 bits of `ta4` */
+static constexpr u16 PIECE = 64;
+
+enum STAGE : u8 { CIC, HALFBAND, BIQUAD, RMS, CHAIN, STAGES };
+
+/** Butterworth high-pass at 0.005 fs and low-pass at 0.05 fs */
+constexpr DSP::section filter[] = {{16024, -32048, 16024, 32040, -15672},
+                                   {329, 658, 329, 25576, -10508}};
+
+void on_level(bool above) {
+    if (above)
+        p1.OUT |= 0b01;
+    else
+        p1.OUT &= ~0b01;
+}
+
+using chain = DSP::pipeline<DSP::cic<4, 3>, DSP::halfband<BLOCK / 4>,
+                            DSP::biquad<filter>, DSP::rms<16, true>,
+                            DSP::threshold<8000, 6000, on_level>>;
+
+DSP::cic<4, 3>              cic_only;
+DSP::halfband<BLOCK>        halfband_only;
+DSP::biquad<filter>         biquad_only;
+DSP::rms<64>                rms_only;
+chain                       pipe;
+ADC12::stream<0x800, BLOCK> stream;
+
+static i16 input[BLOCK];
+static i16 work[BLOCK];
+
+struct {
+    u16 magic;  //!< 0x4453 ("DS") when complete
+    u8  mpy32;  //!< built with `MSP430_DSP_MPY32`
+    u8  mhz;
+    u16 block;
+    u16 runs;
+    struct {
+        u32 samples;  //!< input samples processed
+        u32 cycles;
+    } stage[STAGES];
+    u16 live_blocks;
+    u16 live_overruns;
+} results DATA_PERSISTENT = {};
+
+IRQ_HANDLER(DMA) {
+    if (dma.IV.get() == 2)  // channel 0
+        stream.isr(dma.ch<0>());
+}
+
+/** Tone at fs/64 with pseudo-random noise */
+static void make_input() {
+    u16 lfsr = 0xACE1;
+    for (u16 i = 0; i < BLOCK; i++) {
+        u16 ph   = (i & 63) << 10;
+        i16 tri  = (i16)(ph < 0x8000 ? ph : 0xFFFF - ph) - 16384;
+        lfsr     = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+        input[i] = tri + (i16)((lfsr & 0x0FFF) - 0x0800);
+    }
+}
+
+template <typename Stage>
+NOINLINE void bench(Stage &s, STAGE id) {
+    s.reset();
+    u32 cycles = 0;
+    for (u8 r = 0; r < RUNS; r++) {
+        for (u16 i = 0; i < BLOCK; i++)
+            work[i] = input[i];
+        for (u16 p = 0; p < BLOCK; p += PIECE) {
+            u16 start = ta4.R.get();
+            s.process(work + p, PIECE);
+            cycles += (u16)(ta4.R.get() - start);
+        }
+    }
+    results.stage[id].samples = (u32)BLOCK * RUNS;
+    results.stage[id].cycles  = cycles;
+}
+
+static void start_sampling() {
+    // 8 MHz / 1000 = 8 kHz, TA0.1 rising edge triggers each conversion
+    ta0.CTL       = ta0.TBCLR;
+    ta0.ccr<0>()  = 1000 - 1;
+    ta0.ccr<1>()  = 500;
+    ta0.cctl<1>() = ta0.OUTMOD_RESET_SET;
+    ta0.CTL       = ta0.CLK_SM | ta0.DIV_1 | ta0.UP;
+
+    p1.set_function(MSP430::Driver::GPIO::FUNCTION::F3, 1 << 2);
+    adc12.setup(2, ADC12::TRIGGER::TA0CCR1);
+    stream.start(dma.ch<0>());
+    adc12.enable();
+}
+
+int main() {
+    using MSP430::Driver::Clock::MCLK, MSP430::Driver::Clock::DIV,
+        MSP430::Driver::Clock::DCO;
+
+    wdt_a.stop();
+    cs.New()
+        .Set_DCO(DCO::_8_00MHz)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+    pmm.unlock_pm5();
+
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+
+    ta4.CTL = ta4.DIV_1 | ta4.CLK_SM | ta4.CONT | ta4.TBCLR;
+
+    results.magic = 0;
+    results.mhz   = 8;
+    results.block = BLOCK;
+    results.runs  = RUNS;
+#ifdef MSP430_DSP_MPY32
+    results.mpy32 = 1;
+#else
+    results.mpy32 = 0;
+#endif
+
+    make_input();
+    bench(cic_only, CIC);
+    bench(halfband_only, HALFBAND);
+    bench(biquad_only, BIQUAD);
+    bench(rms_only, RMS);
+    bench(pipe, CHAIN);
+    results.magic = 0x4453;
+
+    pipe.reset();
+    results.live_blocks   = 0;
+    results.live_overruns = 0;
+    start_sampling();
+    MSP430::enable_interrupts();
+
+    while (true) {
+        if (i16 *b = stream.take()) {
+            pipe.process(b, BLOCK);
+            results.live_blocks++;
+            results.live_overruns = stream.overruns;
+        }
+    }
+}
@@ -0,0 +1,111 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Near (low FRAM) vs far (FRAM_HI) table access benchmark.
+// `ta4` counts SMCLK == MCLK cycles, results land in `results` (low FRAM),
+// read them with `mspdebug ... "md results 32"`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u32, MSP430::Far::far_array;
+
+static constexpr u16 N = 256;
+
+struct near_table {
+    u16 data[N];
+};
+
+template <typename Table>
+constexpr Table make_table() {
+    Table t{};
+    for (u16 i = 0; i < N; i++)
+        t.data[i] = i * 251u;
+    return t;
+}
+
+near_table        near_tbl DATA_PERSISTENT = make_table<near_table>();
+far_array<u16, N> far_tbl DATA_PERSISTENT_HIGH =
+    make_table<far_array<u16, N>>();
+static u16   copy_buf[N];
+volatile u32 sink;
+
+struct {
+    u16 near_indexed;  //!< plain `tbl[i]` on low FRAM
+    u16 far_indexed;   //!< `far_tbl[i]`, 20-bit indexed read
+    u16 far_iterated;  //!< `far_iterator::next()`, `@Rn+` read
+    u16 far_cpu_copy;  //!< `far_span::copy_to()`
+    u16 far_dma_copy;  //!< `far_span::dma_to()`, DMA block transfer
+} results DATA_PERSISTENT = {};
+
+static inline u16 now() { return ta4.R.get(); }
+
+NOINLINE u16 bench_near_indexed() {
+    u16 start = now();
+    u32 sum   = 0;
+    for (u16 i = 0; i < N; i++)
+        sum += near_tbl.data[i];
+    sink = sum;
+    return now() - start;
+}
+
+NOINLINE u16 bench_far_indexed() {
+    u16 start = now();
+    u32 sum   = 0;
+    for (u16 i = 0; i < N; i++)
+        sum += far_tbl[i];
+    sink = sum;
+    return now() - start;
+}
+
+NOINLINE u16 bench_far_iterated() {
+    u16  start = now();
+    u32  sum   = 0;
+    auto it    = far_tbl.begin();
+    for (u16 i = 0; i < N; i++)
+        sum += it.next();
+    sink = sum;
+    return now() - start;
+}
+
+NOINLINE u16 bench_far_cpu_copy() {
+    u16 start = now();
+    far_tbl.view().copy_to(copy_buf);
+    return now() - start;
+}
+
+NOINLINE u16 bench_far_dma_copy() {
+    u16 start = now();
+    far_tbl.view().dma_to(copy_buf, dma.ch<0>());
+    return now() - start;
+}
+
+int main() {
+    using MSP430::Driver::Clock::MCLK, MSP430::Driver::Clock::DIV,
+        MSP430::Driver::Clock::DCO;
+
+    wdt_a.stop();
+    cs.New()
+        .Set_DCO(DCO::_8_00MHz)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+    pmm.unlock_pm5();
+
+    ta4.CTL = ta4.DIV_1 | ta4.CLK_SM | ta4.CONT | ta4.TBCLR;
+
+    results.near_indexed = bench_near_indexed();
+    results.far_indexed  = bench_far_indexed();
+    results.far_iterated = bench_far_iterated();
+    results.far_cpu_copy = bench_far_cpu_copy();
+    results.far_dma_copy = bench_far_dma_copy();
+
+    while (true) {
+    }
+}
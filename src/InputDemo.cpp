@@ -0,0 +1,89 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Debounced inputs: LaunchPad buttons S1 (P5.6) and S2 (P5.5) plus all of
+// P3 and P4 as spare switch inputs, 18 pins in total. Presses toggle the
+// LEDs, the CPU sleeps in LPM3 between events.
+//
+// Built with `MSP430_PROFILE`: worst-case handler cycles are the `max` of
+// probes PORT_ISR and TIMER_ISR (`ta4` counts SMCLK == MCLK). Interrupt
+// entry and exit (about 11 cycles plus saved registers) come on top. Dump
+// with `tools/profdump.py` as described in `ProfileDemo.cpp`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u8;
+
+enum PROBE : u8 { PORT_ISR, TIMER_ISR, PROBES };
+
+MSP430::Profile::profiler<0x7C0, 2, PROBES> profiler DATA_PERSISTENT;
+
+/** 20 ms settle time at 32768 Hz ACLK */
+Debounce::debouncer<0x440, 2, 1, 655> buttons;
+
+static constexpr u16 LPM_BITS = 0xF0;
+
+IRQ_HANDLER(P3) {
+    PROFILE_SCOPE(PORT_ISR);
+    buttons.port_isr<3>();
+}
+
+IRQ_HANDLER(P4) {
+    PROFILE_SCOPE(PORT_ISR);
+    buttons.port_isr<4>();
+}
+
+IRQ_HANDLER(P5) {
+    PROFILE_SCOPE(PORT_ISR);
+    buttons.port_isr<5>();
+}
+
+IRQ_HANDLER(TA3_CCR1) {
+    {
+        PROFILE_SCOPE(TIMER_ISR);
+        buttons.timer_isr();
+    }
+    if (!buttons.events.empty())
+        MSP430::SR::clear_on_exit(LPM_BITS);
+}
+
+int main() {
+    wdt_a.stop();
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+
+    pmm.unlock_pm5();
+
+    profiler.start();
+    buttons.start();
+    buttons.attach<3>(0xFF);
+    buttons.attach<4>(0xFF);
+    buttons.attach<5>((1 << 5) | (1 << 6));
+
+    while (true) {
+        Debounce::event e;
+        while (buttons.next(e)) {
+            if (!e.pressed)
+                continue;
+            if (e.pin == 8 * 4 + 6)
+                p1.OUT ^= 0b01;  // S1: red LED
+            else if (e.pin == 8 * 4 + 5)
+                p1.OUT ^= 0b10;  // S2: green LED
+        }
+
+        // GIE and LPM bits are set at once, an event queued after the
+        // check still wakes the loop
+        MSP430::disable_interrupts();
+        if (buttons.events.empty())
+            set_low_power(MSP430::POWER::MODE3);
+        MSP430::enable_interrupts();
+    }
+}
@@ -0,0 +1,222 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Interrupt entry/exit latency and jitter benchmark.
+//
+// A timer compare (CCR0) raises the interrupt at a known count. Entry
+// latency is the timer count at the first handler statement (prologue
+// register saves included) minus CCR0. Exit latency is the count at the
+// first statement after return (or LPM wake-up) minus the count at the
+// last handler statement. Timers count SMCLK == MCLK, so results are CPU
+// cycles.
+//
+// Handlers of increasing register pressure sit on separate timers:
+// light on TA0, medium on TA1, heavy (calls a function) on TA2. Each of
+// them runs in active mode and LPM0..LPM4 for every clock plan. In LPM3/4
+// the timer's clock request keeps SMCLK running, so these numbers show
+// CPU wake-up, not DCO start-up.
+//
+// Results land in `results` (low FRAM). Dump and convert to CSV/JSON with
+// `mspdebug tilib "hexout 0x4000 0x1000 irq.hex"` and
+// `tools/irqbench.py irq.hex`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u32, MSP430::u8;
+
+enum HANDLER : u8 { LIGHT, MEDIUM, HEAVY, HANDLERS };
+enum MODE : u8 { ACTIVE, LPM0, LPM1, LPM2, LPM3, LPM4, MODES };
+enum PLAN : u8 { MHZ_1, MHZ_8, MHZ_16, PLANS };
+
+static constexpr u8  SAMPLES   = 32;
+static constexpr u16 ARM_DELAY = 200;  //!< ticks from arming to interrupt
+static constexpr u16 LPM_BITS  = 0xF0;  //!< CPUOFF | OSCOFF | SCG0 | SCG1
+static constexpr u16 GIE       = 1u << 3u;
+
+struct stat {
+    u16 entry_min;
+    u16 entry_max;
+    u16 exit_min;
+    u16 exit_max;
+    u32 entry_sum;
+    u32 exit_sum;
+
+    void clear() {
+        entry_min = exit_min = 0xFFFF;
+        entry_max = exit_max = 0;
+        entry_sum = exit_sum = 0;
+    }
+
+    void add(u16 entry, u16 exit) {
+        entry_sum += entry;
+        exit_sum += exit;
+        if (entry < entry_min)
+            entry_min = entry;
+        if (entry > entry_max)
+            entry_max = entry;
+        if (exit < exit_min)
+            exit_min = exit;
+        if (exit > exit_max)
+            exit_max = exit;
+    }
+};
+
+struct {
+    u16  magic;  //!< 0x4249 ("IB") when complete
+    u8   plans;
+    u8   modes;
+    u8   handlers;
+    u8   samples;
+    u32  hz[PLANS];
+    stat s[PLANS][MODES][HANDLERS];
+} results DATA_PERSISTENT = {};
+
+volatile u16 t_entry;
+volatile u16 t_exit;
+volatile u8  fired;
+volatile u16 mix[8];
+
+//------------------------
+// Handlers
+
+IRQ_HANDLER(TA0_CCR0) {
+    t_entry       = ta0.R.get();
+    ta0.cctl<0>() = 0;
+    fired         = 1;
+    t_exit        = ta0.R.get();
+    MSP430::SR::clear_on_exit(LPM_BITS);
+}
+
+IRQ_HANDLER(TA1_CCR0) {
+    t_entry       = ta1.R.get();
+    ta1.cctl<0>() = 0;
+    u16 a = mix[0], b = mix[1], c = mix[2], d = mix[3];
+    u16 e = mix[4], f = mix[5], g = mix[6], h = mix[7];
+    mix[0] = a + e;
+    mix[1] = b ^ f;
+    mix[2] = c - g;
+    mix[3] = d + h;
+    mix[4] = a ^ d;
+    mix[5] = b + c;
+    mix[6] = e - h;
+    mix[7] = f ^ g;
+    fired  = 1;
+    t_exit = ta1.R.get();
+    MSP430::SR::clear_on_exit(LPM_BITS);
+}
+
+NOINLINE void heavy_work() {
+    for (u8 i = 0; i < 8; i++)
+        mix[i] = mix[i] * 3 + i;
+}
+
+IRQ_HANDLER(TA2_CCR0) {
+    t_entry       = ta2.R.get();
+    ta2.cctl<0>() = 0;
+    heavy_work();
+    fired  = 1;
+    t_exit = ta2.R.get();
+    MSP430::SR::clear_on_exit(LPM_BITS);
+}
+
+//------------------------
+// Harness
+
+template <typename TA>
+static inline void start(TA &t) {
+    t.CTL = TA::TBCLR;
+    t.CTL = TA::CLK_SM | TA::DIV_1 | TA::CONT;
+}
+
+template <typename TA>
+NOINLINE void measure(TA &t, u8 mode, stat &s) {
+    fired = 0;
+    t.template ccr<0>()  = t.R.get() + ARM_DELAY;
+    t.template cctl<0>() = TA::CCIE;
+
+    switch (mode) {
+        case ACTIVE:
+            MSP430::SR::set(GIE);
+            while (!fired) {
+            }
+            break;
+        case LPM0: MSP430::SR::set(GIE | 0x10); break;
+        case LPM1: MSP430::SR::set(GIE | 0x50); break;
+        case LPM2: MSP430::SR::set(GIE | 0x90); break;
+        case LPM3: MSP430::SR::set(GIE | 0xD0); break;
+        case LPM4: MSP430::SR::set(GIE | 0xF0); break;
+    }
+    u16 back = t.R.get();
+    MSP430::disable_interrupts();
+
+    s.add(t_entry - t.template ccr<0>().get(), back - t_exit);
+}
+
+static u32 clock_plan(u8 plan) {
+    using MSP430::Driver::Clock::ACLK, MSP430::Driver::Clock::DCO,
+        MSP430::Driver::Clock::DIV, MSP430::Driver::Clock::MCLK;
+
+    static constexpr DCO dco[PLANS] = {DCO::_1_00MHz, DCO::_8_00MHz,
+                                       DCO::_16_00MHz};
+    static constexpr u32 hz[PLANS]  = {1000000, 8000000, 16000000};
+
+    // Enough wait states for any plan while switching, then the right ones
+    frctl.set_wait_states(1);
+    cs.New()
+        .Set_DCO(dco[plan])
+        .Set_ACLK(ACLK::VLOCLK, DIV::_1)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+    frctl.set_wait_states(frctl.wait_states(hz[plan]));
+    return hz[plan];
+}
+
+int main() {
+    wdt_a.stop();
+    pmm.unlock_pm5();
+
+    results.magic    = 0;
+    results.plans    = PLANS;
+    results.modes    = MODES;
+    results.handlers = HANDLERS;
+    results.samples  = SAMPLES;
+
+    start(ta0);
+    start(ta1);
+    start(ta2);
+
+    for (u8 p = 0; p < PLANS; p++) {
+        results.hz[p] = clock_plan(p);
+        for (u8 m = 0; m < MODES; m++) {
+            for (u8 h = 0; h < HANDLERS; h++) {
+                stat &s = results.s[p][m][h];
+                s.clear();
+                for (u8 i = 0; i < SAMPLES; i++) {
+                    switch (h) {
+                        case LIGHT: measure(ta0, m, s); break;
+                        case MEDIUM: measure(ta1, m, s); break;
+                        case HEAVY: measure(ta2, m, s); break;
+                    }
+                }
+            }
+        }
+    }
+
+    clock_plan(MHZ_1);
+    results.magic = 0x4249;
+
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+    p1.OUT = 0b10;  // green LED: done
+
+    while (true) {
+    }
+}
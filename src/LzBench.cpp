@@ -0,0 +1,101 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Streaming decompression benchmark.
+//
+// Assets packed at build time by `tools/assetpack.py` (see CMakeLists.txt)
+// are decoded from FRAM_HI in `CHUNK` byte pieces into a LEA RAM buffer.
+// `ta4` counts SMCLK == MCLK cycles of each `read()`, so throughput in
+// bytes per second per MHz of MCLK is `size * 1000000 / cycles`. Every
+// chunk is fed to the CRC16 module, outside the timed part, and checked
+// against the CRC computed by the packer. Read with
+// `mspdebug ... "md results 64"`.
+
+#include <msp430fr5994.h>
+
+#include "assets.h"
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u32, MSP430::u8;
+namespace LZ = MSP430::LZ;
+
+static constexpr u16 CHUNK = 128;
+
+enum ASSET : u8 { WAVE, TEXT, ASSETS };
+
+LZ::decoder<Assets::WINDOW_BITS> lz;
+
+static u8 chunk[CHUNK] DATA_LEA;
+
+struct {
+    u16 magic;  //!< 0x4C42 ("LB") when complete
+    u8  mhz;
+    u8  window_bits;
+    u16 chunk;
+    struct {
+        u32 size;    //!< bytes decoded
+        u32 packed;  //!< bytes in FRAM, with header
+        u32 cycles;
+        u16 crc_ok;  //!< 1 if output matches
+    } asset[ASSETS];
+} results DATA_PERSISTENT = {};
+
+static void bench(ASSET id, const u8 *asset, u32 packed, u16 expected) {
+    u32 cycles = 0;
+    u32 size   = 0;
+    lz.open(asset);
+    crc.seed();
+    while (true) {
+        u16 start = ta4.R.get();
+        u16 n     = lz.read(chunk, CHUNK);
+        cycles += (u16)(ta4.R.get() - start);
+        if (!n)
+            break;
+        size += n;
+        for (u16 i = 0; i < n; i++)
+            crc.add(chunk[i]);
+    }
+    results.asset[id].size   = size;
+    results.asset[id].packed = packed;
+    results.asset[id].cycles = cycles;
+    results.asset[id].crc_ok = crc.result() == expected;
+}
+
+int main() {
+    using MSP430::Driver::Clock::MCLK, MSP430::Driver::Clock::DIV,
+        MSP430::Driver::Clock::DCO;
+
+    wdt_a.stop();
+    cs.New()
+        .Set_DCO(DCO::_8_00MHz)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+    pmm.unlock_pm5();
+
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+
+    ta4.CTL = ta4.DIV_1 | ta4.CLK_SM | ta4.CONT | ta4.TBCLR;
+
+    results.magic       = 0;
+    results.mhz         = 8;
+    results.window_bits = Assets::WINDOW_BITS;
+    results.chunk       = CHUNK;
+
+    bench(WAVE, Assets::asset_wave, Assets::wave_packed, Assets::wave_crc);
+    bench(TEXT, Assets::asset_text, Assets::text_packed, Assets::text_crc);
+    results.magic = 0x4C42;
+
+    // Green LED: both assets decoded intact, red LED: not
+    bool ok = results.asset[WAVE].crc_ok && results.asset[TEXT].crc_ok;
+    p1.OUT  = ok ? 0b10 : 0b01;
+    while (true) {
+    }
+}
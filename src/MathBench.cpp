@@ -0,0 +1,200 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Integer math benchmark: `MSP430::Math` against the libgcc routines.
+//
+// Each operation runs over the same `COUNT` pseudo-random inputs, once with
+// `Math` and once the plain C++ way, which calls libgcc (`__mspabi_divu`,
+// `__mspabi_divul`, ...). Divisors of the reference are read from volatile
+// variables, so the compiler cannot replace the call by its own reciprocal.
+// `ta4` counts SMCLK == MCLK cycles, timer reads are included in both.
+// Operations without a libgcc counterpart (`isqrt`, CORDIC) have `libgcc`
+// 0. `errors` counts results that differ from the reference; for `isqrt`
+// the result is checked directly. Read with `mspdebug ... "md results 64"`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::i16, MSP430::i32, MSP430::u16, MSP430::u32, MSP430::u8;
+namespace Math = MSP430::Math;
+
+static constexpr u8 COUNT = 64;
+
+enum OP : u8 {
+    DIV16_CONST,
+    DIV32_CONST,
+    DIV32_16,
+    ISQRT,
+    SINCOS,
+    ATAN2,
+    UTOA,
+    OPS
+};
+
+struct {
+    u16 magic;  //!< 0x4D42 ("MB") when complete
+    u8  mhz;
+    u8  count;
+    struct {
+        u32 math;    //!< cycles for `count` operations
+        u32 libgcc;  //!< same with libgcc, 0 if none
+    } op[OPS];
+    u16 errors;
+} results DATA_PERSISTENT = {};
+
+static u32 input[COUNT];
+static u32 reference[COUNT];
+
+// Divisors the compiler cannot see, for the libgcc reference
+volatile u16 ten          DATA_PERSISTENT = 10;
+volatile u32 ten_thousand DATA_PERSISTENT = 10000;
+volatile u32 sink;
+
+static void make_input() {
+    u16 lfsr = 0xACE1;
+    for (u8 i = 0; i < COUNT; i++) {
+        u32 v = 0;
+        for (u8 k = 0; k < 2; k++) {
+            lfsr = (lfsr >> 1) ^ (-(lfsr & 1u) & 0xB400u);
+            v    = (v << 16) | lfsr;
+        }
+        // Spread magnitudes, so short numbers are measured too
+        input[i] = v >> (i & 15);
+    }
+}
+
+static inline u16 divisor(u8 i) { return (u16)(input[i] >> 3) | 1; }
+
+/** Decimal digits by repeated division, as usually written */
+static u8 naive_utoa(u32 v, char *out) {
+    char d[10];
+    u8   n = 0;
+    do {
+        d[n++] = '0' + (char)(v % ten);
+        v /= ten;
+    } while (v);
+    for (u8 i = 0; i < n; i++)
+        out[i] = d[n - 1 - i];
+    out[n] = 0;
+    return n;
+}
+
+static inline void check(u32 got, u32 want) {
+    if (got != want)
+        results.errors++;
+}
+
+/** Cycles of `f(0)` .. `f(COUNT - 1)`, each timed alone: 16-bit timer */
+template <typename F>
+NOINLINE u32 measure(F f) {
+    u32 cycles = 0;
+    for (u8 i = 0; i < COUNT; i++) {
+        u16 start = ta4.R.get();
+        f(i);
+        cycles += (u16)(ta4.R.get() - start);
+    }
+    return cycles;
+}
+
+static void bench_div() {
+    u16 d16 = ten;
+    u32 d32 = ten_thousand;
+
+    results.op[DIV16_CONST].libgcc =
+        measure([&](u8 i) { reference[i] = (u16)input[i] / d16; });
+    results.op[DIV16_CONST].math = measure(
+        [&](u8 i) { sink = Math::div<10>((u16)input[i]); });
+    for (u8 i = 0; i < COUNT; i++)
+        check(Math::div<10>((u16)input[i]), reference[i]);
+
+    results.op[DIV32_CONST].libgcc =
+        measure([&](u8 i) { reference[i] = input[i] / d32; });
+    results.op[DIV32_CONST].math =
+        measure([&](u8 i) { sink = Math::div<10000>(input[i]); });
+    for (u8 i = 0; i < COUNT; i++)
+        check(Math::div<10000>(input[i]), reference[i]);
+
+    results.op[DIV32_16].libgcc = measure(
+        [&](u8 i) { reference[i] = input[i] / (u32)divisor(i); });
+    results.op[DIV32_16].math = measure([&](u8 i) {
+        u16 r;
+        sink = Math::div32(input[i], divisor(i), r);
+    });
+    for (u8 i = 0; i < COUNT; i++) {
+        u16 r;
+        check(Math::div32(input[i], divisor(i), r), reference[i]);
+        check(r, input[i] - reference[i] * divisor(i));
+    }
+}
+
+static void bench_other() {
+    results.op[ISQRT].math =
+        measure([&](u8 i) { sink = Math::isqrt(input[i]); });
+    for (u8 i = 0; i < COUNT; i++) {
+        u32 r    = Math::isqrt(input[i]);
+        bool low = r < 0xFFFF && (r + 1) * (r + 1) <= input[i];
+        if (r * r > input[i] || low)
+            results.errors++;
+    }
+
+    results.op[SINCOS].math = measure([&](u8 i) {
+        i16 s, c;
+        Math::sincos((i16)input[i], s, c);
+        sink = s + c;
+    });
+
+    results.op[ATAN2].math = measure([&](u8 i) {
+        sink = Math::atan2((i16)input[i], (i16)(input[i] >> 16));
+    });
+
+    char a[12], b[12];
+    results.op[UTOA].libgcc =
+        measure([&](u8 i) { sink = naive_utoa(input[i], a); });
+    results.op[UTOA].math =
+        measure([&](u8 i) { sink = Math::utoa(input[i], b); });
+    for (u8 i = 0; i < COUNT; i++) {
+        u8 n = naive_utoa(input[i], a);
+        check(Math::utoa(input[i], b), n);
+        for (u8 k = 0; k < n; k++)
+            check(b[k], a[k]);
+    }
+}
+
+int main() {
+    using MSP430::Driver::Clock::MCLK, MSP430::Driver::Clock::DIV,
+        MSP430::Driver::Clock::DCO;
+
+    wdt_a.stop();
+    cs.New()
+        .Set_DCO(DCO::_8_00MHz)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+    pmm.unlock_pm5();
+
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+
+    ta4.CTL = ta4.DIV_1 | ta4.CLK_SM | ta4.CONT | ta4.TBCLR;
+
+    results.magic  = 0;
+    results.mhz    = 8;
+    results.count  = COUNT;
+    results.errors = 0;
+
+    make_input();
+    bench_div();
+    bench_other();
+    results.magic = 0x4D42;
+
+    // Green LED: all results match, red LED: some do not
+    p1.OUT = results.errors ? 0b01 : 0b10;
+    while (true) {
+    }
+}
@@ -0,0 +1,107 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// DMA pattern generators:
+//   - WS2812 strip of 8 LEDs on P3.0, a frame every 20 ms from TA0 at
+//     16 MHz / 7 per slot, sent with `play()`,
+//   - stepper motor on P4.0..P4.3, 500 half steps per second from TA1,
+//     streamed from two refilled buffers.
+// The CPU only encodes frames and refills buffers, it sleeps in LPM0
+// (DMA needs no CPU, timers keep SMCLK) the rest of the time. Between
+// frames `delay_ms()` sleeps in LPM1: the running SMCLK timers hold
+// their `Power` requests.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u8;
+using MSP430::Driver::Pattern::generator, MSP430::Driver::Pattern::stepper,
+    MSP430::Driver::Pattern::ws2812;
+
+static constexpr u8  LEDS  = 8;
+static constexpr u16 BYTES = 3 * LEDS;
+static constexpr u16 STEPS = 32;
+
+generator<0x340, 3, 0x220>            strip;  // P3
+generator<0x380, 3, 0x221, u8, STEPS> motor;  // P4
+
+static u8 frame[ws2812<>::size(BYTES)];
+static u8 grb[BYTES];
+static u8 phase;
+
+static constexpr u16 LPM0 = 0x10;
+
+IRQ_HANDLER(DMA) {
+    switch (dma.IV.get()) {
+        case 2: strip.isr(dma.ch<0>()); break;
+        case 4: motor.isr(dma.ch<1>()); break;
+    }
+    MSP430::SR::clear_on_exit(LPM0);
+}
+
+IRQ_HANDLER(TA3_CCR0) { MSP430::Delay::timer::isr(); }
+
+static void rainbow(u8 t) {
+    for (u8 i = 0; i < LEDS; i++) {
+        u8 h           = t + 32 * i;
+        grb[3 * i]     = h < 128 ? h : 255 - h;  // G
+        grb[3 * i + 1] = 255 - h;                // R
+        grb[3 * i + 2] = h > 128 ? h - 128 : 0;  // B
+    }
+}
+
+int main() {
+    using MSP430::Driver::Clock::ACLK, MSP430::Driver::Clock::DCO,
+        MSP430::Driver::Clock::DIV, MSP430::Driver::Clock::MCLK;
+
+    wdt_a.stop();
+    frctl.set_wait_states(1);
+    cs.New()
+        .Set_DCO(DCO::_16_00MHz)
+        .Set_ACLK(ACLK::LFXTCLK, DIV::_1)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+
+    p3.OUT = 0;
+    p3.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b00000001);
+    p4.OUT = 0;
+    p4.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b00001111);
+    pmm.unlock_pm5();
+
+    // 2 ms per half step: 16 MHz / 8 / 4000
+    stepper<>::half_steps(motor.buffer[0], STEPS, phase, true);
+    stepper<>::half_steps(motor.buffer[1], STEPS, phase, true);
+    motor.start(4000, ta1.CLK_SM | ta1.DIV_8);
+    motor.stream(dma.ch<1>());
+
+    strip.start(7);
+    MSP430::enable_interrupts();
+
+    for (u8 t = 0;; t++) {
+        rainbow(t);
+        ws2812<>::encode(grb, BYTES, frame, 0b00000001);
+        strip.play(dma.ch<0>(), frame, sizeof(frame));
+
+        // Sleep until the frame is out, refilling the motor on the way
+        while (strip.busy(dma.ch<0>())) {
+            if (u8 *b = motor.back()) {
+                stepper<>::half_steps(b, STEPS, phase, true);
+                motor.commit();
+            }
+            MSP430::disable_interrupts();
+            if (strip.busy(dma.ch<0>()) && motor.back() == nullptr)
+                set_low_power(MSP430::POWER::MODE0);
+            MSP430::enable_interrupts();
+        }
+
+        // Frame period, far longer than the latch (`ws2812<>::RESET_US`)
+        MSP430::Delay::delay_ms<20>();
+    }
+}
@@ -0,0 +1,53 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Profiling probes demo. Built with `MSP430_PROFILE` defined (see
+// CMakeLists.txt); without it all probes vanish and `profiler` is unused.
+// `ta4` counts SMCLK == MCLK cycles. Dump the table with
+// `mspdebug tilib "save_raw <&profiler> <size> prof.bin"` and decode it
+// with `tools/profdump.py prof.bin`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u32;
+
+enum PROBE : MSP430::u8 { MAIN_LOOP, FILTER, BLINK, PROBES };
+
+MSP430::Profile::profiler<0x7C0, 2, PROBES> profiler DATA_PERSISTENT;
+
+static u16   samples[64];
+volatile u32 sink;
+
+NOINLINE void filter(u16 n) {
+    PROFILE_SCOPE(FILTER);
+    u32 acc = 0;
+    for (u16 i = 0; i < n; i++)
+        acc += samples[i] * (i & 7);
+    sink = acc;
+}
+
+int main() {
+    wdt_a.stop();
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+    pmm.unlock_pm5();
+
+    profiler.start();
+
+    for (u16 n = 0;; n++) {
+        PROFILE_SCOPE(MAIN_LOOP);
+        filter(n & 63);
+        if ((n & 0xFF) == 0) {
+            PROFILE_SCOPE(BLINK);
+            p1.OUT ^= 1;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Sleeps in LPM3.5 with RTC_C as the only running peripheral, waking up
+// every minute to flash the red LED. No timer ISR and no CPU cycles are
+// spent on timekeeping.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u8;
+
+MSP430::Driver::RTC::backup bak DATA_PERSISTENT = {};
+
+int main() {
+    using MSP430::Driver::Clock::ACLK, MSP430::Driver::Clock::MCLK,
+        MSP430::Driver::Clock::DIV, MSP430::Driver::GPIO::FUNCTION,
+        MSP430::Driver::GPIO::MODE, MSP430::Driver::RTC::EVENT;
+
+    wdt_a.stop();
+
+    // Same I/O state before unlocking, on cold start and on wake-up
+    p1.OUT = 0;
+    p1.set_mode(MODE::OUT, 0b11);
+    pj.set_function(FUNCTION::F1, 0b110000);  // LFXIN/LFXOUT
+    pmm.unlock_pm5();
+
+    if (pmm.woke_from_lpmx5() && rtc.running()) {
+        // RTC kept running and has the minute event pending. Interrupts are
+        // served as soon as they're enabled.
+        bak.wakeups++;
+        MSP430::enable_interrupts();
+    } else {
+        bak.init();
+        cs.New()
+            .Set_LFXT()
+            .Set_ACLK(ACLK::LFXTCLK, DIV::_1)
+            .Set_MCLK(MCLK::DCOCLK, DIV::_8)
+            .Set_SMCLK(MCLK::DCOCLK, DIV::_8);
+        rtc.start({0, 0, 12, 0, 1, 1, 2020});
+        rtc.event(EVENT::MINUTE);
+    }
+
+    pmm.enter_lpm35();
+}
+
+IRQ_HANDLER(RTC_C) {
+    rtc.isr();
+    p1.OUT.bit<0>().toggle();
+}
@@ -0,0 +1,159 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// Calibrated ADC samples: `TLV::scale` against the formulas as written in
+// the family guide, evaluated per sample with 32-bit products and, for
+// temperature, a division (`__mspabi_divli`).
+//
+// Both run over the same `COUNT` readings with the 1.2 V reference, ADC
+// readings across the 12-bit range, sensor readings from 0 to 100 degrees
+// C. `ta4` counts SMCLK == MCLK cycles, timer reads included in both, so
+// cycles per sample are `cycles / count`. `load` is the cycles of
+// `calibration::load()` on this boot, long on the first one, a CRC check
+// after that. `errors` counts results more than 2 counts (0.02 degree)
+// off the reference: the formulas truncate after each product, `scale`
+// rounds its precomputed gain and the corrected reading, and truncates
+// the temperature once.
+// Read with `mspdebug ... "md results 64"`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::i16, MSP430::i32, MSP430::u16, MSP430::u32, MSP430::u8;
+namespace TLV = MSP430::TLV;
+
+static constexpr u8 COUNT = 64;
+
+enum OP : u8 { CORRECT, CELSIUS, OPS };
+
+TLV::calibration cal DATA_PERSISTENT = {};
+
+struct {
+    u16 magic;  //!< 0x5442 ("TB") when complete
+    u8  mhz;
+    u8  count;
+    u16 tlv_ok;  //!< 1 if the descriptor is intact
+    u32 load;
+    struct {
+        u32 scale;    //!< cycles for `count` samples
+        u32 formula;  //!< same, per-sample formula
+    } op[OPS];
+    u16 errors;
+} results DATA_PERSISTENT = {};
+
+static u16 input[COUNT];
+static i16 output[COUNT];
+static i16 reference[COUNT];
+
+static inline i16 distance(i16 a, i16 b) { return a > b ? a - b : b - a; }
+
+static void bench_correct(const TLV::adc12_cal *adc,
+                          const TLV::ref_cal   *vr) {
+    const TLV::scale &s = cal[TLV::VREF::_1V2];
+    for (u8 i = 0; i < COUNT; i++)
+        input[i] = (u16)(i * 65);
+
+    u32 cycles = 0;
+    for (u8 i = 0; i < COUNT; i++) {
+        u16 start = ta4.R.get();
+        output[i] = s.correct(input[i]);
+        cycles += (u16)(ta4.R.get() - start);
+    }
+    results.op[CORRECT].scale = cycles;
+
+    cycles = 0;
+    for (u8 i = 0; i < COUNT; i++) {
+        u16 start    = ta4.R.get();
+        i32 v        = ((i32)input[i] * vr->f_1v2) >> 15;
+        v            = (v * adc->gain) >> 15;
+        reference[i] = (i16)(v + adc->offset);
+        cycles += (u16)(ta4.R.get() - start);
+    }
+    results.op[CORRECT].formula = cycles;
+
+    for (u8 i = 0; i < COUNT; i++)
+        if (distance(output[i], reference[i]) > 2)
+            results.errors++;
+}
+
+static void bench_celsius(const TLV::adc12_cal *adc) {
+    const TLV::scale &s   = cal[TLV::VREF::_1V2];
+    i16               t30 = adc->t30_1v2;
+    i16               d   = adc->t85_1v2 - t30;
+
+    // 0..100 degrees C, extrapolated from the calibration points
+    for (u8 i = 0; i < COUNT; i++) {
+        i16 celsius = (i16)(i * 100 / COUNT);
+        input[i]    = (u16)(t30 + (i16)((i32)d * (celsius - 30) / 55));
+    }
+
+    u32 cycles = 0;
+    for (u8 i = 0; i < COUNT; i++) {
+        u16 start = ta4.R.get();
+        output[i] = s.centi_celsius(input[i]);
+        cycles += (u16)(ta4.R.get() - start);
+    }
+    results.op[CELSIUS].scale = cycles;
+
+    cycles = 0;
+    for (u8 i = 0; i < COUNT; i++) {
+        u16 start    = ta4.R.get();
+        i32 v        = (i32)((i16)input[i] - t30) * 5500 / d;
+        reference[i] = (i16)(v + 3000);
+        cycles += (u16)(ta4.R.get() - start);
+    }
+    results.op[CELSIUS].formula = cycles;
+
+    for (u8 i = 0; i < COUNT; i++)
+        if (distance(output[i], reference[i]) > 2)
+            results.errors++;
+}
+
+int main() {
+    using MSP430::Driver::Clock::MCLK, MSP430::Driver::Clock::DIV,
+        MSP430::Driver::Clock::DCO;
+
+    wdt_a.stop();
+    cs.New()
+        .Set_DCO(DCO::_8_00MHz)
+        .Set_MCLK(MCLK::DCOCLK, DIV::_1)
+        .Set_SMCLK(MCLK::DCOCLK, DIV::_1);
+    pmm.unlock_pm5();
+
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+
+    ta4.CTL = ta4.DIV_1 | ta4.CLK_SM | ta4.CONT | ta4.TBCLR;
+
+    results.magic  = 0;
+    results.mhz    = 8;
+    results.count  = COUNT;
+    results.errors = 0;
+
+    u16  start     = ta4.R.get();
+    bool ok        = cal.load();
+    results.load   = (u16)(ta4.R.get() - start);
+    results.tlv_ok = ok;
+
+    auto *adc = (const TLV::adc12_cal *)TLV::find(TLV::ADC12,
+                                                  sizeof(TLV::adc12_cal));
+    auto *vr =
+        (const TLV::ref_cal *)TLV::find(TLV::REF, sizeof(TLV::ref_cal));
+    if (ok) {
+        bench_correct(adc, vr);
+        bench_celsius(adc);
+    }
+    results.magic = 0x5442;
+
+    // Green LED: calibration loaded and matching the formulas, red LED: not
+    p1.OUT = ok && !results.errors ? 0b10 : 0b01;
+    while (true) {
+    }
+}
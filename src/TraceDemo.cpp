@@ -0,0 +1,42 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// FRAM event trace demo. Last 256 events survive reset; read them with
+// `mspdebug tilib "hexout 0x10000 0x1000 trace.hex"` and
+// `tools/tracedump.py TraceDemo trace.hex --hz 32768`.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16;
+
+typedef MSP430::Trace::timer<0x7C0, 2> trace_clock;
+
+MSP430::Trace::buffer<trace_clock, 256> trace DATA_PERSISTENT_HIGH = {};
+
+int main() {
+    wdt_a.stop();
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+    p5.set_mode(MSP430::Driver::GPIO::MODE::IN_PULLUP, 1 << 6);
+    pmm.unlock_pm5();
+
+    trace_clock::start();
+    trace.boot();
+
+    for (u16 n = 0;; n++) {
+        if ((n & 0x3FFF) == 0) {
+            p1.OUT ^= 1;
+            TRACE(trace, "led toggled, pass %u", n);
+        }
+        if (!(p5.IN || (1 << 6)))
+            TRACE(trace, "button S1 held, P5 = 0x%02x", p5.IN.get());
+    }
+}
@@ -0,0 +1,68 @@
+/* --------------------------------------------------------------------------
+ * -- (C) 2020 Paweł Kraszewski                                            --
+ * --                                                                      --
+ * -- Licensed as:                                                         --
+ * --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+ * --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+ * ------------------------------------------------------------------------*/
+
+// A/B image demo, built twice: UpdateDemoA (slot A, version 1) and
+// UpdateDemoB (slot B, version 2). Load the boot stage and both images:
+//
+//     mspdebug tilib "prog Boot"
+//     mspdebug tilib "load_raw UpdateDemoA.bin 0x10000"
+//     mspdebug tilib "load_raw UpdateDemoB.bin 0x2A000"
+//
+// The boot stage starts the newer image, B. Slot A blinks the red LED,
+// slot B the green one; the blink timer interrupt goes through the boot
+// stage trampolines. The blink pattern comes from a constant table in
+// the slot, picked by a start counter in the image's persistent data,
+// which restarts from zero after each update.
+//   - S1 retires the running image and reboots: the boot stage falls back
+//     to the other slot, as after a failed update,
+//   - S2 commits the other slot again (it is still intact) and reboots
+//     into whichever image is newer.
+
+#include <msp430fr5994.h>
+
+#pragma ide diagnostic ignored "EndlessLoop"
+
+using namespace MSP430::FR5994;
+using MSP430::u16, MSP430::u8, MSP430::Boot::image;
+
+static constexpr u8 S1 = 1 << 6;
+static constexpr u8 S2 = 1 << 5;
+
+// LED state per 250 ms step, MSB first
+static const u8 PATTERNS[4] = {0b10101010, 0b11001100, 0b11101110, 0b11110000};
+
+u16 starts DATA_PERSISTENT = 0;
+
+IRQ_HANDLER(TA3_CCR0) { MSP430::Delay::timer::isr(); }
+
+int main() {
+    wdt_a.stop();
+    u8 led     = image::running() ? 0b10 : 0b01;
+    u8 pattern = PATTERNS[starts++ % sizeof(PATTERNS)];
+    p1.OUT = 0;
+    p1.set_mode(MSP430::Driver::GPIO::MODE::OUT, 0b11);
+    p5.set_mode(MSP430::Driver::GPIO::MODE::IN_PULLUP, S1 | S2);
+    pmm.unlock_pm5();
+    MSP430::enable_interrupts();
+
+    for (u8 step = 0;; step = (step + 1) & 7) {
+        if (pattern & (0x80 >> step))
+            p1.OUT |= led;
+        else
+            p1.OUT &= ~led;
+        MSP430::Delay::delay_ms<250>();
+
+        u8 in = p5.IN.get();
+        if (!(in & S1)) {
+            image::retire(image::running());
+            image::reboot();
+        }
+        if (!(in & S2) && image::commit(image::spare()))
+            image::reboot();
+    }
+}
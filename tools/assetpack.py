@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Pack constant assets for MSP430::LZ::decoder (see lib/drivers/lz.h).
+
+Each input file is compressed (LZSS, matches limited to the decoder
+window) and written to an assembly source as `asset_<name>` in
+`.persistent.high`. The header declares the symbols, their decoded size
+and CRC-16/CCITT-FALSE of the decoded bytes, for checks with the CRC16
+module:
+
+    assetpack.py -o assets.S --header assets.h --window 10 \\
+        font=font.bin wave=wave.bin
+
+`--check` decodes every packed asset again before writing.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x5A4C
+MIN_MATCH = 3
+CHAIN = 256  # candidates tried per position
+
+
+def pack(data, wbits):
+    window = 1 << wbits
+    longest = MIN_MATCH + (1 << (16 - wbits)) - 1
+    heads = {}
+    out = bytearray()
+    group = []
+    flags = 0
+
+    def flush():
+        nonlocal flags, group
+        out.append(flags)
+        for item in group:
+            out.extend(item)
+        flags, group = 0, []
+
+    def remember(i):
+        if i + MIN_MATCH <= len(data):
+            heads.setdefault(data[i:i + MIN_MATCH], []).append(i)
+
+    i = 0
+    while i < len(data):
+        best, dist = 0, 0
+        for j in reversed(heads.get(data[i:i + MIN_MATCH], [])[-CHAIN:]):
+            if i - j > window:
+                break
+            n = MIN_MATCH
+            limit = min(longest, len(data) - i)
+            while n < limit and data[j + n] == data[i + n]:
+                n += 1
+            if n > best:
+                best, dist = n, i - j
+                if n == limit:
+                    break
+        if best >= MIN_MATCH:
+            word = (dist - 1) | ((best - MIN_MATCH) << wbits)
+            group.append(struct.pack("<H", word))
+            step = best
+        else:
+            flags |= 1 << len(group)
+            group.append(data[i:i + 1])
+            step = 1
+        for k in range(i, i + step):
+            remember(k)
+        i += step
+        if len(group) == 8:
+            flush()
+    if group:
+        flush()
+    return struct.pack("<HBBI", MAGIC, wbits, 0, len(data)) + bytes(out)
+
+
+def unpack(blob):
+    magic, wbits, _, size = struct.unpack_from("<HBBI", blob)
+    if magic != MAGIC:
+        raise ValueError("not an asset")
+    mask = (1 << wbits) - 1
+    out = bytearray()
+    pos = 8
+    while len(out) < size:
+        flags = blob[pos]
+        pos += 1
+        for bit in range(8):
+            if len(out) >= size:
+                break
+            if flags >> bit & 1:
+                out.append(blob[pos])
+                pos += 1
+            else:
+                word, = struct.unpack_from("<H", blob, pos)
+                pos += 2
+                start = len(out) - (word & mask) - 1
+                for k in range((word >> wbits) + MIN_MATCH):
+                    out.append(out[start + k])
+    return bytes(out)
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = (crc << 1) ^ 0x1021 if crc & 0x8000 else crc << 1
+        crc &= 0xFFFF
+    return crc
+
+
+def assembly(assets):
+    out = ["/* Generated by tools/assetpack.py, do not edit */", "",
+           '.section .persistent.high, "aw"']
+    for name, _, blob in assets:
+        out += ["", ".balign 2", ".global asset_%s" % name,
+                "asset_%s:" % name]
+        for k in range(0, len(blob), 16):
+            out.append("    .byte " + ",".join(
+                "0x%02X" % b for b in blob[k:k + 16]))
+    return "\n".join(out) + "\n"
+
+
+def header(assets, wbits):
+    out = ["// Generated by tools/assetpack.py, do not edit", "",
+           "#pragma once", "", "#include <drivers/lz.h>", "",
+           "namespace Assets {",
+           "    static constexpr MSP430::u8 WINDOW_BITS = %d;" % wbits, ""]
+    for name, data, blob in assets:
+        out += ["    /** %d bytes, packed %d */" % (len(data), len(blob)),
+                '    extern "C" const MSP430::u8 asset_%s[];' % name,
+                "    static constexpr MSP430::u32 %s_size = %d;"
+                % (name, len(data)),
+                "    static constexpr MSP430::u32 %s_packed = %d;"
+                % (name, len(blob)),
+                "    static constexpr MSP430::u16 %s_crc = 0x%04X;"
+                % (name, crc16(data)), ""]
+    out[-1] = "}  // namespace Assets"
+    return "\n".join(out) + "\n"
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("assets", nargs="+", metavar="name=file")
+    ap.add_argument("-o", "--output", required=True, help="assembly source")
+    ap.add_argument("--header", required=True, help="C++ header")
+    ap.add_argument("--window", type=int, default=10,
+                    help="window bits, 8..12 (default 10: 1 KiB of RAM)")
+    ap.add_argument("--check", action="store_true",
+                    help="decode packed assets again and compare")
+    args = ap.parse_args()
+    if not 8 <= args.window <= 12:
+        sys.exit("window bits must be 8..12")
+
+    assets = []
+    for spec in args.assets:
+        name, sep, path = spec.partition("=")
+        if not sep or not name.isidentifier():
+            sys.exit("expected name=file, got %s" % spec)
+        with open(path, "rb") as f:
+            data = f.read()
+        blob = pack(data, args.window)
+        if args.check and unpack(blob) != data:
+            sys.exit("%s: decoded asset differs" % name)
+        assets.append((name, data, blob))
+        print("%-12s %7d -> %7d bytes (%.1f%%)" % (
+            name, len(data), len(blob), 100.0 * len(blob) / max(1, len(data))),
+            file=sys.stderr)
+
+    with open(args.output, "w") as f:
+        f.write(assembly(assets))
+    with open(args.header, "w") as f:
+        f.write(header(assets, args.window))
+
+
+if __name__ == "__main__":
+    main()
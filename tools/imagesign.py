@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Set the CRC of an A/B application image (see lib/drivers/boot.h).
+
+Input is the raw slot content, as written by
+
+    msp430-elf-objcopy -O binary -j .image -j .image.persistent X X.bin
+
+The CRC (CRC-16/CCITT-FALSE, as the CRC16 module computes it) covers
+header bytes 2.. up to `length`, that is header, code and constants;
+persistent data behind them is not covered.
+
+    imagesign.py X.bin [--check]
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0xAB1A
+HEADER = struct.Struct("<HHHHII")
+SLOTS = ("A", "B")
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    ap.add_argument("image")
+    ap.add_argument("--check", action="store_true",
+                    help="only verify the stored CRC")
+    args = ap.parse_args()
+
+    with open(args.image, "rb") as f:
+        blob = bytearray(f.read())
+    if len(blob) < HEADER.size:
+        sys.exit("%s: too short for a header" % args.image)
+    crc, magic, version, slot, length, entry = HEADER.unpack_from(blob)
+    if magic != MAGIC or slot > 1:
+        sys.exit("%s: not an image (magic 0x%04X)" % (args.image, magic))
+    if not HEADER.size <= length <= len(blob):
+        sys.exit("%s: bad length %d" % (args.image, length))
+
+    actual = crc16(blob[2:length])
+    if args.check:
+        ok = actual == crc
+        print("%s: slot %s, version %d, %d B, crc 0x%04X %s" %
+              (args.image, SLOTS[slot], version, length, crc,
+               "ok" if ok else "BAD (0x%04X)" % actual))
+        sys.exit(0 if ok else 1)
+
+    struct.pack_into("<H", blob, 0, actual)
+    with open(args.image, "wb") as f:
+        f.write(blob)
+    print("%s: slot %s, version %d, %d B, entry 0x%05X, crc 0x%04X" %
+          (args.image, SLOTS[slot], version, length, entry, actual))
+
+
+if __name__ == "__main__":
+    main()
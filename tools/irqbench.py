@@ -0,0 +1,92 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Convert IrqBench results to CSV or JSON.
+
+    mspdebug tilib "hexout 0x4000 0x1000 irq.hex"
+    irqbench.py irq.hex > irq.csv
+    irqbench.py irq.hex --json > irq.json
+
+All latencies are in CPU cycles. Jitter is max - min over the samples.
+"""
+
+import argparse
+import csv
+import json
+import struct
+import sys
+
+from tracedump import load_dump
+
+MAGIC = 0x4249
+HEADER = struct.Struct("<HBBBB")
+STAT = struct.Struct("<HHHHII")
+MODES = ["active", "lpm0", "lpm1", "lpm2", "lpm3", "lpm4"]
+HANDLERS = ["light", "medium", "heavy"]
+
+
+def decode(image):
+    pos = 0
+    while True:
+        pos = image.find(struct.pack("<H", MAGIC), pos)
+        if pos < 0:
+            sys.exit("complete IrqBench results not found")
+        _, plans, modes, handlers, samples = HEADER.unpack_from(image, pos)
+        if 0 < plans <= 8 and 0 < modes <= 8 and 0 < handlers <= 8 \
+                and samples:
+            break
+        pos += 1
+    pos += HEADER.size
+    hz = struct.unpack_from("<%dI" % plans, image, pos)
+    pos += 4 * plans
+    rows = []
+    for p in range(plans):
+        for m in range(modes):
+            for h in range(handlers):
+                emin, emax, xmin, xmax, esum, xsum = STAT.unpack_from(
+                    image, pos)
+                pos += STAT.size
+                rows.append({
+                    "mclk_hz": hz[p],
+                    "mode": MODES[m] if m < len(MODES) else str(m),
+                    "handler": HANDLERS[h] if h < len(HANDLERS) else str(h),
+                    "samples": samples,
+                    "entry_min": emin,
+                    "entry_avg": round(esum / samples, 2),
+                    "entry_max": emax,
+                    "entry_jitter": emax - emin,
+                    "exit_min": xmin,
+                    "exit_avg": round(xsum / samples, 2),
+                    "exit_max": xmax,
+                    "exit_jitter": xmax - xmin,
+                })
+    return rows
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("dump", help="memory dump, Intel HEX or raw binary")
+    ap.add_argument("--base", type=lambda x: int(x, 0),
+                    help="start address of raw dump")
+    ap.add_argument("--json", action="store_true", help="JSON output")
+    args = ap.parse_args()
+
+    _, image = load_dump(args.dump, args.base or 0)
+    rows = decode(image)
+    if args.json:
+        json.dump(rows, sys.stdout, indent=1)
+        print()
+    else:
+        out = csv.DictWriter(sys.stdout, fieldnames=list(rows[0]))
+        out.writeheader()
+        out.writerows(rows)
+
+
+if __name__ == "__main__":
+    main()
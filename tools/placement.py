@@ -0,0 +1,282 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Profile-guided code placement: write a linker script fragment.
+
+Functions are compiled into sections of their own (`-ffunction-sections`),
+so a fragment can place each one. From a function-level profile of a
+firmware ELF, the fragment
+
+  - copies the hottest functions to SRAM at startup, up to `--ram` bytes
+    (no FRAM wait states above 8 MHz, see `lib/rt.S`),
+  - keeps the other hot functions at the start of low FRAM, each followed
+    by the hot functions it calls, so they share FRAM cache lines,
+  - moves code that did not run to FRAM_HI, leaving low FRAM to data,
+    which `-mlarge` code reaches with 16-bit addresses.
+
+Functions in explicit sections (`IRQ_HANDLER`, `CODE_HIGH`) stay where
+they are. Not for A/B images, `image.ld` places their code itself.
+
+The profile is either a simulator trace or the on-target profiler:
+
+    placement.py DspBench --trace pc.txt -o placement/DspBench.ld
+    placement.py ProfileDemo --profile prof.bin --names names.txt -o X.ld
+
+`--trace` reads executed addresses, one per line, hex in the first field
+(e.g. from an instruction trace of `msp430-elf-run`); each address counts
+for the function holding it. `--profile` reads a `Profile::profiler`
+table as `tools/profdump.py` does, `names.txt` maps probe ids to function
+names, and the cycles of each probe count for the function. Probes also
+cover callees, so functions called from hot ones count as hot unless the
+profile names them itself.
+
+Before/after: CMake builds `<bench>Placed` next to `<bench>` when
+`placement/<bench>.ld` exists. Both store their cycle counts in
+`results`, read them from each with `mspdebug`.
+"""
+
+import argparse
+import bisect
+import os
+import re
+import struct
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+import profdump  # noqa: E402
+
+STT_FUNC = 2
+CALL = re.compile(r"\s(?:calla?|bra?)\s+#(0x[0-9a-fA-F]+|\d+)")
+FUNC = re.compile(r"^([0-9a-fA-F]+) <(.+)>:$")
+SKIP = ("irq_", "vec_")
+
+
+def functions(path):
+    """Return {name: (address, size)} of function symbols."""
+    with open(path, "rb") as f:
+        d = f.read()
+    if d[:4] != b"\x7fELF" or d[4] != 1 or d[5] != 1:
+        sys.exit("%s: not a 32-bit little-endian ELF file" % path)
+    shoff, = struct.unpack_from("<I", d, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", d, 0x2E)
+    sections = [struct.unpack_from("<IIIIIII", d, shoff + i * shentsize)
+                for i in range(shnum)]
+    found = {}
+    for _, typ, _, _, off, size, link in sections:
+        if typ != 2:  # SHT_SYMTAB
+            continue
+        strtab = sections[link][4]
+        for pos in range(off, off + size, 16):
+            name, value, sym_size, info, _, _ = struct.unpack_from(
+                "<IIIBBH", d, pos)
+            if info & 0xF != STT_FUNC or not sym_size:
+                continue
+            name = d[strtab + name:d.index(b"\0", strtab + name)].decode()
+            found[name] = (value, sym_size)
+    return found
+
+
+def call_graph(path, funcs, objdump):
+    """Return {caller: [callee, ...]} from direct calls and jumps."""
+    by_addr = {a: n for n, (a, _) in funcs.items()}
+    try:
+        text = subprocess.run([objdump, "-d", path], capture_output=True,
+                              text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        print("warning: %s failed, hot code kept in profile order" % objdump,
+              file=sys.stderr)
+        return {}
+    graph = {}
+    caller = None
+    for line in text.splitlines():
+        m = FUNC.match(line)
+        if m:
+            caller = m.group(2)
+            continue
+        m = CALL.search(line)
+        if caller and m:
+            callee = by_addr.get(int(m.group(1), 0))
+            if callee and callee != caller:
+                graph.setdefault(caller, [])
+                if callee not in graph[caller]:
+                    graph[caller].append(callee)
+    return graph
+
+
+def demangled(names, cxxfilt):
+    try:
+        out = subprocess.run([cxxfilt], input="\n".join(names),
+                             capture_output=True, text=True,
+                             check=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError):
+        return dict(zip(names, names))
+    return dict(zip(names, out))
+
+
+def weights_from_trace(path, funcs):
+    starts = sorted((a, n) for n, (a, _) in funcs.items())
+    keys = [a for a, _ in starts]
+    weight = dict.fromkeys(funcs, 0)
+    with open(path) as f:
+        for line in f:
+            field = line.split(None, 1)
+            if not field:
+                continue
+            try:
+                pc = int(field[0].rstrip(":"), 16)
+            except ValueError:
+                continue
+            i = bisect.bisect_right(keys, pc) - 1
+            if i >= 0:
+                name = starts[i][1]
+                if pc < funcs[name][0] + funcs[name][1]:
+                    weight[name] += 1
+    return weight
+
+
+def weights_from_profile(path, names_path, funcs, cxxfilt):
+    with open(path, "rb") as f:
+        blob = f.read()
+    found = profdump.find_table(blob)
+    if not found:
+        sys.exit("profiler table not found")
+    pos, probes, buckets, _ = found
+    names = profdump.load_names(names_path)
+    plain = demangled(list(funcs), cxxfilt)
+    weight = {}
+    for i, count, total, _, _, _ in profdump.decode(blob, pos, probes,
+                                                    buckets):
+        if not count or i not in names:
+            continue
+        wanted = names[i]
+        match = [n for n in funcs if n == wanted or plain[n] == wanted
+                 or plain[n].startswith(wanted + "(")]
+        if not match:
+            print("warning: probe %d: no function %s" % (i, wanted),
+                  file=sys.stderr)
+        for n in match:
+            weight[n] = weight.get(n, 0) + total
+    return weight
+
+
+def place(funcs, weight, graph, hot_share, ram_budget, closed):
+    """Return (ram, hot, cold) lists of function names."""
+    total = sum(weight.values())
+    ranked = sorted((n for n in weight if weight[n]), key=lambda n:
+                    (-weight[n], n))
+    hot = []
+    acc = 0
+    for n in ranked:
+        if total and acc >= hot_share * total:
+            break
+        hot.append(n)
+        acc += weight[n]
+
+    # Callees of hot code run with it, unless the profile knows better
+    if not closed:
+        todo = list(hot)
+        while todo:
+            for c in graph.get(todo.pop(), []):
+                if c not in weight and c not in hot:
+                    hot.append(c)
+                    todo.append(c)
+
+    ram = []
+    left = ram_budget
+    for n in sorted(hot, key=lambda n: -weight.get(n, 0) / funcs[n][1]):
+        size = (funcs[n][1] + 1) & ~1
+        if size <= left and weight.get(n, 0):
+            ram.append(n)
+            left -= size
+
+    # Hot FRAM code in call order: each function followed by its callees
+    order = []
+    rest = [n for n in hot if n not in ram]
+
+    def visit(n):
+        if n in order or n not in rest:
+            return
+        order.append(n)
+        for c in sorted(graph.get(n, []), key=lambda c: -weight.get(c, 0)):
+            visit(c)
+
+    for n in rest:
+        visit(n)
+
+    placed = set(ram) | set(hot)
+    cold = sorted((n for n in funcs if n not in placed
+                   and not weight.get(n, 0) and not n.startswith(SKIP)),
+                  key=lambda n: funcs[n][0])
+    return sorted(ram, key=lambda n: funcs[n][0]), order, cold
+
+
+def patterns(names):
+    return ["    *(.text.%s .text.*.%s)" % (n, n) for n in names]
+
+
+def fragment(source, ram, hot, cold):
+    out = ["/* Generated by tools/placement.py from %s, do not edit. */"
+           % source, "", "SECTIONS", "{"]
+    out += ["  .text.ram : ALIGN(2)", "  {", "    __ramtext_start = .;"]
+    out += patterns(ram)
+    out += ["    . = ALIGN(2);", "    __ramtext_end = .;", "  } >RAM AT>FRAM",
+            "  __ramtext_load = LOADADDR(.text.ram);", ""]
+    out += ["  .text.hot : ALIGN(2)", "  {"] + patterns(hot)
+    out += ["  } >FRAM", ""]
+    out += ["  .text.cold : ALIGN(2)", "  {"] + patterns(cold)
+    out += ["  } >FRAM_HI", "}", "INSERT BEFORE .fram_high;", ""]
+    return "\n".join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("elf", help="firmware built with -ffunction-sections")
+    src = ap.add_mutually_exclusive_group(required=True)
+    src.add_argument("--trace", help="executed addresses, hex, one per line")
+    src.add_argument("--profile", help="profiler table dump")
+    ap.add_argument("-n", "--names", help="probe id to function name map")
+    ap.add_argument("--hot", type=float, default=0.95,
+                    help="share of profile weight kept hot (default 0.95)")
+    ap.add_argument("--ram", type=int, default=0,
+                    help="bytes of SRAM for the hottest code (default 0)")
+    ap.add_argument("--prefix", default="msp430-elf-",
+                    help="toolchain prefix for objdump and c++filt")
+    ap.add_argument("-o", "--output", help="fragment, default stdout")
+    args = ap.parse_args()
+
+    funcs = functions(args.elf)
+    if args.trace:
+        weight = weights_from_trace(args.trace, funcs)
+        closed = True
+    else:
+        if not args.names:
+            sys.exit("--profile needs --names")
+        weight = weights_from_profile(args.profile, args.names, funcs,
+                                      args.prefix + "c++filt")
+        closed = False
+    graph = call_graph(args.elf, funcs, args.prefix + "objdump")
+    ram, hot, cold = place(funcs, weight, graph, args.hot, args.ram, closed)
+
+    text = fragment(os.path.basename(args.trace or args.profile), ram, hot,
+                    cold)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+    for label, names in (("SRAM", ram), ("hot", hot), ("cold", cold)):
+        size = sum(funcs[n][1] for n in names)
+        print("%-5s %4d functions %6d bytes" % (label, len(names), size),
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
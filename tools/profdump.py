@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Decode MSP430::Profile::profiler table.
+
+Input is any binary blob containing the table image: a raw memory dump
+(e.g. `mspdebug tilib "save_raw 0x4000 0x800 prof.bin"`) or bytes captured
+from UART after `profiler.dump(uart_putc)`. The table is found by its
+header, so the blob may start anywhere before it.
+
+    profdump.py prof.bin [-n names.txt] [--mclk 8000000]
+
+`names.txt` holds `id name` pairs, one per line.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x4650
+VERSION = 1
+HEADER = struct.Struct("<HBBBBH")
+
+
+def find_table(blob):
+    pos = 0
+    while True:
+        pos = blob.find(struct.pack("<H", MAGIC), pos)
+        if pos < 0 or pos + HEADER.size > len(blob):
+            return None
+        magic, version, probes, buckets, _, overhead = HEADER.unpack_from(
+            blob, pos)
+        if version == VERSION and 0 < probes and 0 < buckets <= 17:
+            return pos, probes, buckets, overhead
+        pos += 1
+
+
+def decode(blob, pos, probes, buckets):
+    rec = struct.Struct("<IIHH%dH" % buckets)
+    pos += HEADER.size
+    for i in range(probes):
+        if pos + rec.size > len(blob):
+            raise ValueError("table truncated at probe %d" % i)
+        count, total, lo, hi, *hist = rec.unpack_from(blob, pos)
+        pos += rec.size
+        yield i, count, total, lo, hi, hist
+
+
+def load_names(path):
+    names = {}
+    if path:
+        with open(path) as f:
+            for line in f:
+                line = line.split("#", 1)[0].split(None, 1)
+                if len(line) == 2:
+                    names[int(line[0], 0)] = line[1].strip()
+    return names
+
+
+def bucket_range(b):
+    if b == 0:
+        return "0"
+    return "%d..%d" % (1 << (b - 1), (1 << b) - 1)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("image", help="binary dump, '-' for stdin")
+    ap.add_argument("-n", "--names", help="probe id to name map")
+    ap.add_argument("--mclk", type=int, default=0,
+                    help="MCLK in Hz, adds microsecond columns")
+    ap.add_argument("--no-hist", action="store_true",
+                    help="skip histograms")
+    args = ap.parse_args()
+
+    if args.image == "-":
+        blob = sys.stdin.buffer.read()
+    else:
+        with open(args.image, "rb") as f:
+            blob = f.read()
+
+    found = find_table(blob)
+    if not found:
+        sys.exit("profiler table not found")
+    pos, probes, buckets, overhead = found
+    names = load_names(args.names)
+
+    print("table at +0x%X, %d probes, overhead %d cycles" %
+          (pos, probes, overhead))
+    print("%-4s %-20s %10s %8s %8s %10s" %
+          ("id", "name", "count", "min", "max", "avg"))
+    rows = list(decode(blob, pos, probes, buckets))
+    for i, count, total, lo, hi, hist in rows:
+        if not count:
+            continue
+        avg = total / count
+        line = "%-4d %-20s %10d %8d %8d %10.1f" % (
+            i, names.get(i, ""), count, lo, hi, avg)
+        if args.mclk:
+            line += "  (%.2f us avg, %.2f us max)" % (
+                avg * 1e6 / args.mclk, hi * 1e6 / args.mclk)
+        print(line)
+
+    if args.no_hist:
+        return
+    for i, count, total, lo, hi, hist in rows:
+        if not count:
+            continue
+        print(("\n[%d] %s" % (i, names.get(i, ""))).rstrip())
+        top = max(hist)
+        for b, n in enumerate(hist):
+            if n:
+                bar = "#" * max(1, n * 50 // top)
+                sat = "+" if n == 0xFFFF else " "
+                print("  %13s %6d%s %s" % (bucket_range(b), n, sat, bar))
+
+
+if __name__ == "__main__":
+    main()
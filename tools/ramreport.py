@@ -0,0 +1,139 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Per-region memory report from link maps and -fstack-usage output.
+
+    ramreport.py <build dir> [target ...]
+
+For every `<target>.map` in the build directory prints usage of each
+memory region (RAM, RAM_TINY, RAM_LEA, FRAM, FRAM_HI, ...), the stack
+reserve taken from RAM, and the largest stack frames found in `*.su`
+files of that target. Without a call graph the frames are not summed;
+check them against the reserve and against `Stack::high_water()` measured
+on the device.
+"""
+
+import glob
+import os
+import re
+import sys
+
+SECTION = re.compile(r"^(\.\S+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)")
+SECTION_NAME = re.compile(r"^(\.\S+)\s*$")
+ADDR_SIZE = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s*$")
+REGION = re.compile(r"^(\w+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)")
+STACK = re.compile(r"(0x[0-9a-fA-F]+)\s+__stack_size\s*=")
+TOP_FRAMES = 8
+
+
+def parse_map(path):
+    regions = []
+    sections = []
+    stack = 0
+    with open(path) as f:
+        lines = f.read().splitlines()
+
+    state = None
+    pending = None
+    for line in lines:
+        if line.startswith("Memory Configuration"):
+            state = "mem"
+            continue
+        if line.startswith("Linker script and memory map"):
+            state = "map"
+            continue
+        if state == "mem":
+            m = REGION.match(line)
+            if m and m.group(1) != "Name" and m.group(1) != "default":
+                regions.append((m.group(1), int(m.group(2), 16),
+                                int(m.group(3), 16)))
+        elif state == "map":
+            m = STACK.search(line)
+            if m:
+                stack = int(m.group(1), 16)
+            if pending:
+                m = ADDR_SIZE.match(line)
+                if m:
+                    sections.append((pending, int(m.group(1), 16),
+                                     int(m.group(2), 16)))
+                pending = None
+                continue
+            m = SECTION.match(line)
+            if m:
+                sections.append((m.group(1), int(m.group(2), 16),
+                                 int(m.group(3), 16)))
+                continue
+            m = SECTION_NAME.match(line)
+            if m:
+                pending = m.group(1)
+    return regions, sections, stack
+
+
+def parse_su(paths):
+    frames = []
+    for path in paths:
+        with open(path) as f:
+            for line in f:
+                parts = line.rstrip("\n").split("\t")
+                if len(parts) != 3:
+                    continue
+                where, size, kind = parts
+                func = where.split(":", 3)[-1]
+                frames.append((int(size), func, kind))
+    return sorted(set(frames), reverse=True)
+
+
+def report(build, target):
+    regions, sections, stack = parse_map(os.path.join(build, target + ".map"))
+    print("== %s" % target)
+    print("  %-10s %8s %8s %8s %8s %6s" %
+          ("region", "origin", "length", "used", "free", "used%"))
+    for name, origin, length in regions:
+        used = sum(size for _, addr, size in sections
+                   if size and origin <= addr < origin + length)
+        extra = ""
+        if name == "RAM" and stack:
+            used += stack
+            extra = "  (incl. %d B stack reserve)" % stack
+        print("  %-10s %8s %8d %8d %8d %5.1f%%%s" %
+              (name, "0x%05X" % origin, length, used, length - used,
+               100.0 * used / length if length else 0, extra))
+
+    su = glob.glob(os.path.join(build, "CMakeFiles", target + ".dir", "**",
+                                "*.su"), recursive=True)
+    su += glob.glob(os.path.join(build, target + "*.su"))
+    frames = parse_su(su)
+    if not frames:
+        print("  no -fstack-usage data")
+        return
+    print("  largest stack frames:")
+    for size, func, kind in frames[:TOP_FRAMES]:
+        print("    %6d  %-8s %s" % (size, kind, func))
+    isr = sum(size for size, func, _ in frames if func.startswith("irq_"))
+    if isr:
+        print("  all handlers nested at once: %d B" % isr)
+    for size, func, kind in frames:
+        if kind.startswith("dynamic") and kind != "dynamic,bounded":
+            print("  WARNING: unbounded dynamic frame in %s" % func)
+
+
+def main():
+    if len(sys.argv) < 2:
+        sys.exit(__doc__)
+    build = sys.argv[1]
+    targets = sys.argv[2:] or sorted(
+        os.path.basename(p)[:-4]
+        for p in glob.glob(os.path.join(build, "*.map")))
+    for t in targets:
+        if os.path.exists(os.path.join(build, t + ".map")):
+            report(build, t)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+# --------------------------------------------------------------------------
+# -- (C) 2020 Paweł Kraszewski                                            --
+# --                                                                      --
+# -- Licensed as:                                                         --
+# --   Attribution-NonCommercial-ShareAlike 4.0 International             --
+# --   https://creativecommons.org/licenses/by-nc-sa/4.0/legalcode        --
+# --------------------------------------------------------------------------
+
+"""Decode MSP430::Trace::buffer into a timeline.
+
+Format strings are read from the `.trace.fmt` section of the firmware ELF,
+the buffer from a memory dump taken from the device:
+
+    mspdebug tilib "hexout 0x10000 0x1000 trace.hex"
+    tracedump.py firmware.elf trace.hex --hz 32768
+
+Raw binary dumps need their start address (`--base`). Buffer is located by
+its symbol (`--symbol`, default `trace`), or found by its header.
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x5254
+HEADER = struct.Struct("<HHHH")
+RECORD = struct.Struct("<HHI")
+
+
+class Elf:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+        d = self.data
+        if d[:4] != b"\x7fELF" or d[4] != 1 or d[5] != 1:
+            raise ValueError("not a 32-bit little-endian ELF file")
+        shoff, = struct.unpack_from("<I", d, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", d, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            name, typ, _, addr, off, size, link = struct.unpack_from(
+                "<IIIIIII", d, shoff + i * shentsize)
+            self.sections.append([name, typ, addr, off, size, link])
+        strtab = self.sections[shstrndx]
+        for s in self.sections:
+            s[0] = self._str(strtab[3], s[0])
+
+    def _str(self, base, off):
+        end = self.data.index(b"\0", base + off)
+        return self.data[base + off:end].decode()
+
+    def section(self, name):
+        for s in self.sections:
+            if s[0] == name:
+                return self.data[s[3]:s[3] + s[4]]
+        return None
+
+    def symbol(self, wanted):
+        for s in self.sections:
+            if s[1] != 2:  # SHT_SYMTAB
+                continue
+            strtab = self.sections[s[5]]
+            for off in range(s[3], s[3] + s[4], 16):
+                name, value, size, _, _, _ = struct.unpack_from(
+                    "<IIIBBH", self.data, off)
+                if name and self._str(strtab[3], name) == wanted:
+                    return value, size
+        return None
+
+
+def load_dump(path, base):
+    """Return dump as (start address, bytearray)."""
+    with open(path, "rb") as f:
+        raw = f.read()
+    if not raw.startswith(b":"):
+        if base is None:
+            sys.exit("raw dump needs --base")
+        return base, bytearray(raw)
+    mem = {}
+    upper = 0
+    for line in raw.decode().split():
+        n = int(line[1:3], 16)
+        addr = int(line[3:7], 16)
+        typ = int(line[7:9], 16)
+        payload = bytes.fromhex(line[9:9 + 2 * n])
+        if typ == 0:
+            for i, b in enumerate(payload):
+                mem[upper + addr + i] = b
+        elif typ == 2:
+            upper = int.from_bytes(payload, "big") << 4
+        elif typ == 4:
+            upper = int.from_bytes(payload, "big") << 16
+    lo, hi = min(mem), max(mem)
+    image = bytearray(hi - lo + 1)
+    for a, b in mem.items():
+        image[a - lo] = b
+    return lo, image
+
+
+def formats(elf):
+    sect = elf.section(".trace.fmt")
+    if sect is None:
+        sys.exit(".trace.fmt section missing in ELF")
+    table = {}
+    pos = 0
+    while pos < len(sect):
+        if sect[pos] == 0:  # alignment padding
+            pos += 1
+            continue
+        end = sect.index(b"\0", pos)
+        fmt = sect[pos:end].decode(errors="replace")
+        end2 = sect.index(b"\0", end + 1)
+        where = sect[end + 1:end2].decode(errors="replace")
+        table[pos] = (fmt, where)
+        pos = end2 + 1
+    return table
+
+
+def render(fmt, arg):
+    fmt = fmt.replace("%u", "%d").replace("%lu", "%d").replace("%ld", "%d")
+    if "%d" in fmt or "%i" in fmt:
+        arg = arg - (1 << 32) if arg & 0x80000000 else arg
+    try:
+        return fmt % arg if "%" in fmt else fmt
+    except (TypeError, ValueError):
+        return "%s [0x%08X]" % (fmt, arg)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("elf", help="firmware ELF")
+    ap.add_argument("dump", help="memory dump, Intel HEX or raw binary")
+    ap.add_argument("--base", type=lambda x: int(x, 0),
+                    help="start address of raw dump")
+    ap.add_argument("--symbol", default="trace", help="buffer symbol")
+    ap.add_argument("--hz", type=float, default=0,
+                    help="time source rate, prints seconds instead of ticks")
+    ap.add_argument("--where", action="store_true",
+                    help="print source location of each event")
+    args = ap.parse_args()
+
+    elf = Elf(args.elf)
+    fmts = formats(elf)
+    base, image = load_dump(args.dump, args.base)
+
+    sym = elf.symbol(args.symbol)
+    if sym and base <= sym[0] < base + len(image):
+        pos = sym[0] - base
+    else:
+        pos = image.find(struct.pack("<H", MAGIC))
+        if pos < 0:
+            sys.exit("trace buffer not found in dump")
+
+    magic, size, head, wraps = HEADER.unpack_from(image, pos)
+    if magic != MAGIC:
+        sys.exit("no trace buffer at 0x%X" % (base + pos))
+    recs = pos + HEADER.size
+    order = range(head, head + size) if wraps else range(head)
+    print("buffer at 0x%X, %d records, %d wraps" %
+          (base + pos, size, wraps))
+
+    t = 0
+    last = None
+    for i in order:
+        stamp, ev, arg = RECORD.unpack_from(image, recs + (i % size) * 8)
+        fmt, where = fmts.get(ev, ("<unknown event 0x%04X>" % ev, "?"))
+        if fmt.startswith("--- boot"):
+            t = 0
+        elif last is not None:
+            t += (stamp - last) & 0xFFFF
+        last = stamp
+        when = "%12.6f" % (t / args.hz) if args.hz else "%10d" % t
+        line = "%s  %s" % (when, render(fmt, arg))
+        if args.where:
+            line += "  (%s)" % where
+        print(line)
+
+
+if __name__ == "__main__":
+    main()